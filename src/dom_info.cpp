@@ -26,7 +26,8 @@
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/erase.hpp>
 #include <migraphx/ranges.hpp>
-#include <unordered_set>
+#include <numeric>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -58,35 +59,56 @@ template <class Visitor>
 dominator_info compute_dominator_generic(Visitor v)
 {
     dominator_info info;
-    std::unordered_map<instruction_ref, std::unordered_set<instruction_ref>> instr2_doms;
-    for(instruction_ref ins : iterator_for(v.get_nodes()))
+    const auto& m = v.get_nodes();
+    // Index used for instructions without a dominator and for inputs from
+    // outside of the module
+    const std::size_t none = m.size();
+    // The immediate dominator of each instruction by its index in the module
+    std::vector<std::size_t> idom(m.size(), none);
+    std::vector<instruction_ref> nodes;
+    nodes.reserve(m.size());
+    auto get_index = [&](instruction_ref ins) {
+        return m.has_instruction(ins) ? m.get_index(ins) : none;
+    };
+    // Walk up the dominator tree from both instructions until they meet. A
+    // dominator always comes before the instructions it dominates, so the
+    // later of the two is moved up.
+    auto intersect = [&](std::size_t x, std::size_t y) {
+        while(x != y)
+        {
+            if(x == none or y == none)
+                return none;
+            if(x > y)
+                x = idom[x];
+            else
+                y = idom[y];
+        }
+        return x;
+    };
+    for(instruction_ref ins : iterator_for(m))
     {
+        auto i = nodes.size();
+        nodes.push_back(ins);
         const std::vector<instruction_ref>& children = v.get_children(ins);
         if(children.size() == 1)
         {
             info.ins2idom[ins] = children.front();
-            instr2_doms[ins]   = instr2_doms[children.front()];
+            idom[i]            = get_index(children.front());
         }
         else if(children.size() > 1)
         {
-            auto&& doms = instr2_doms[ins];
-
-            doms = instr2_doms[children.front()];
-            std::for_each(children.begin() + 1, children.end(), [&](instruction_ref child) {
-                auto&& child_doms = instr2_doms[child];
-                erase_if(doms, [&](auto x) { return not contains(child_doms, x); });
-            });
-            auto iter = std::find_if(doms.begin(), doms.end(), [&](auto dom1) {
-                return std::none_of(doms.begin(), doms.end(), [&](auto dom2) {
-                    if(dom1 == dom2)
-                        return false;
-                    return info.strictly_dominate(dom1, dom2);
-                });
-            });
-            if(iter != doms.end())
-                info.ins2idom[ins] = *iter;
+            auto dom = std::accumulate(children.begin() + 1,
+                                       children.end(),
+                                       get_index(children.front()),
+                                       [&](std::size_t x, instruction_ref child) {
+                                           return intersect(x, get_index(child));
+                                       });
+            if(dom != none)
+            {
+                idom[i]            = dom;
+                info.ins2idom[ins] = nodes[dom];
+            }
         }
-        instr2_doms[ins].insert(ins);
     }
     return info;
 }
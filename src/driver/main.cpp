@@ -48,6 +48,7 @@
 #include <migraphx/eliminate_identity.hpp>
 #include <migraphx/eliminate_pad.hpp>
 #include <migraphx/generate.hpp>
+#include <migraphx/host_allocator.hpp>
 #include <migraphx/pass_manager.hpp>
 #include <migraphx/propagate_constant.hpp>
 #include <migraphx/quantization.hpp>
@@ -519,6 +520,9 @@ struct compiler
         ap(to_int8, {"--int8"}, ap.help("Quantize for int8"), ap.set_value(true));
         ap(to_fp8, {"--fp8"}, ap.help("Quantize for fp8"), ap.set_value(true));
         ap(to_int4, {"--int4-weights"}, ap.help("Quantize weights for int4"), ap.set_value(true));
+        ap(co.memory_budget,
+           {"--memory-budget"},
+           ap.help("Memory in bytes that compilation tries to stay under"));
     }
 
     auto params(const program& p)
@@ -762,6 +766,43 @@ struct perf : command<perf>
     }
 };
 
+struct memory_cmd : command<memory_cmd>
+{
+    compiler c;
+    std::size_t n = 5;
+    void parse(argument_parser& ap)
+    {
+        c.parse(ap);
+        ap(n, {"--top", "-n"}, ap.help("Number of the largest live results to show per module"));
+    }
+
+    void run()
+    {
+        std::cout << "Compiling ... " << std::endl;
+        auto p = c.compile();
+        std::cout << "Memory report:" << std::endl;
+        p.memory_report(std::cout, n);
+        auto total = p.get_memory_usage().total_bytes();
+        if(c.co.memory_budget > 0 and total > c.co.memory_budget)
+        {
+            std::cout << "[WARNING]: Estimated memory of " << total
+                      << " bytes is over the memory budget of " << c.co.memory_budget
+                      << " bytes" << std::endl;
+        }
+        std::cout << "Allocating params ... " << std::endl;
+        auto m = c.params(p);
+        reset_host_allocation_peak();
+        auto before = get_host_allocation_stats();
+        p.eval(m);
+        p.finish();
+        auto after = get_host_allocation_stats();
+        std::cout << "Host memory allocated while running: "
+                  << after.peak_bytes - before.bytes << " bytes" << std::endl;
+        std::cout << "Host memory in huge pages: " << after.huge_page_bytes << " bytes"
+                  << std::endl;
+    }
+};
+
 struct roctx : command<roctx>
 {
     compiler c;
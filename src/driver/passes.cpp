@@ -31,6 +31,7 @@
 #include <migraphx/eliminate_concat.hpp>
 #include <migraphx/eliminate_contiguous.hpp>
 #include <migraphx/eliminate_data_type.hpp>
+#include <migraphx/eliminate_duplicate_literals.hpp>
 #include <migraphx/eliminate_identity.hpp>
 #include <migraphx/eliminate_pad.hpp>
 #include <migraphx/fuse_pointwise.hpp>
@@ -49,6 +50,7 @@
 #include <migraphx/simplify_dyn_ops.hpp>
 #include <migraphx/simplify_qdq.hpp>
 #include <migraphx/simplify_reshapes.hpp>
+#include <migraphx/unroll_loop.hpp>
 
 #include <migraphx/ranges.hpp>
 #include <unordered_map>
@@ -69,6 +71,7 @@ std::unordered_map<std::string, pass> create_passes_lookup()
         eliminate_concat{},
         eliminate_contiguous{},
         eliminate_data_type{},
+        eliminate_duplicate_literals{},
         eliminate_identity{},
         eliminate_pad{},
         fuse_pointwise{},
@@ -87,6 +90,7 @@ std::unordered_map<std::string, pass> create_passes_lookup()
         simplify_dyn_ops{},
         simplify_qdq{},
         simplify_reshapes{},
+        unroll_loop{},
     };
     // clang-format on
     for(const auto& pass : passes)
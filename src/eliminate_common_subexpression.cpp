@@ -27,16 +27,31 @@
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/functional.hpp>
+#include <migraphx/hash.hpp>
 
 #include <unordered_set>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+// Instructions that compare equal have the same operator, arguments and
+// literal data, so only instructions with the same hash need to be compared
+static std::size_t hash_instruction(instruction_ref ins)
+{
+    std::size_t h = ins->get_operator().hash();
+    for(auto input : ins->inputs())
+        hash_combine(h, input);
+    for(auto* mod : ins->module_inputs())
+        hash_combine(h, mod);
+    if(ins->name() == "@literal")
+        hash_combine(h, hash_value(ins->get_literal()));
+    return h;
+}
+
 template <class Range>
 void cse_range(module& m, Range&& r)
 {
-    std::unordered_multimap<std::string, instruction_ref> instructions;
+    std::unordered_multimap<std::size_t, instruction_ref> instructions;
     std::unordered_set<instruction_ref> processed_ins;
     for(auto ins : r)
     {
@@ -44,8 +59,9 @@ void cse_range(module& m, Range&& r)
         if(ins->outputs().empty())
             continue;
 
-        // Find instruction with the same name
-        auto found_instructions = range(instructions.equal_range(ins->name()));
+        // Find instruction with the same hash
+        auto h                  = hash_instruction(ins);
+        auto found_instructions = range(instructions.equal_range(h));
         for(const auto& pp : found_instructions)
         {
             auto eq = pp.second;
@@ -62,11 +78,11 @@ void cse_range(module& m, Range&& r)
                          [&](auto x) { return m.has_instruction(x); });
 
             std::sort(outputs.begin(), outputs.end(), [&](auto x, auto y) {
-                return std::distance(eq, x) < std::distance(eq, y);
+                return m.precedes(x, y);
             });
             cse_range(m, outputs);
         }
-        instructions.emplace(ins->name(), ins);
+        instructions.emplace(h, ins);
     }
 }
 
@@ -86,9 +86,7 @@ void eliminate_concat::apply(module& m) const
             auto sorted_allocations = allocations;
             std::sort(sorted_allocations.begin(),
                       sorted_allocations.end(),
-                      [&](instruction_ref x, instruction_ref y) {
-                          return std::distance(m.begin(), x) < std::distance(m.begin(), y);
-                      });
+                      [&](instruction_ref x, instruction_ref y) { return m.precedes(x, y); });
             // Move "super" allocation to the front
             auto first = sorted_allocations.front();
             auto super = m.move_instruction(last, first);
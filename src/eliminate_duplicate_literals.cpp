@@ -0,0 +1,102 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/eliminate_duplicate_literals.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/ranges.hpp>
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+static bool same_literal(const literal& x, const literal& y)
+{
+    if(x.get_shape() != y.get_shape())
+        return false;
+    if(x.data() == y.data())
+        return true;
+    return std::memcmp(x.data(), y.data(), x.get_shape().bytes()) == 0;
+}
+
+void eliminate_duplicate_literals::apply(program& p) const
+{
+    // Literals already kept by a module, used to share buffers across modules
+    std::unordered_multimap<std::size_t, literal> shared;
+    for(auto* m : p.get_modules())
+    {
+        std::vector<instruction_ref> literals;
+        for(auto ins : iterator_for(*m))
+        {
+            if(ins->name() == "@literal" and not ins->get_literal().empty())
+                literals.push_back(ins);
+        }
+        std::unordered_multimap<std::size_t, instruction_ref> kept;
+        for(auto ins : literals)
+        {
+            const auto& lit = ins->get_literal();
+            auto h          = hash_value(lit);
+            auto found      = range(kept.equal_range(h));
+            auto it = std::find_if(found.begin(), found.end(), [&](const auto& pp) {
+                return same_literal(pp.second->get_literal(), lit);
+            });
+            if(it != found.end())
+            {
+                m->replace_instruction(ins, it->second);
+                m->remove_instruction(ins);
+                continue;
+            }
+            auto other = range(shared.equal_range(h));
+            auto jt    = std::find_if(other.begin(), other.end(), [&](const auto& pp) {
+                return same_literal(pp.second, lit);
+            });
+            auto rep = ins;
+            if(jt != other.end())
+            {
+                if(jt->second.data() != lit.data())
+                    rep = m->insert_literal(ins, jt->second);
+            }
+            else if(intern)
+            {
+                auto interned = intern_literal(lit);
+                if(interned.data() != lit.data())
+                    rep = m->insert_literal(ins, interned);
+            }
+            if(rep != ins)
+            {
+                m->replace_instruction(ins, rep);
+                m->remove_instruction(ins);
+            }
+            kept.emplace(h, rep);
+            if(jt == other.end())
+                shared.emplace(h, rep->get_literal());
+        }
+    }
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -22,6 +22,7 @@
  * THE SOFTWARE.
  */
 #include <migraphx/fuse_reduce.hpp>
+#include <migraphx/builtin.hpp>
 #include <migraphx/check_shapes.hpp>
 #include <migraphx/dead_code_elimination.hpp>
 #include <migraphx/eliminate_common_subexpression.hpp>
@@ -35,14 +36,170 @@
 #include <migraphx/register_op.hpp>
 #include <migraphx/rewrite_reshapes.hpp>
 #include <migraphx/param_utils.hpp>
+#include <migraphx/par_for.hpp>
 #include <iterator>
 #include <map>
+#include <memory>
+#include <mutex>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_REDUCE_FUSION)
 
+// Dimensions reduced together for one output: the reduced axes are kept and
+// the other dimensions are set to 1
+static std::vector<std::size_t> row_lens(std::vector<std::size_t> lens,
+                                         const std::vector<std::int64_t>& axes)
+{
+    for(auto i : range(lens.size()))
+    {
+        if(not contains(axes, static_cast<std::int64_t>(i)))
+            lens[i] = 1;
+    }
+    return lens;
+}
+
+static shape row_shape(const shape& s, const std::vector<std::int64_t>& axes)
+{
+    return {s.type(), row_lens(s.lens(), axes), s.strides()};
+}
+
+static argument
+get_row(const argument& a, std::vector<std::size_t> idx, const std::vector<std::int64_t>& axes)
+{
+    const auto& s = a.get_shape();
+    std::transform(idx.begin(), idx.end(), s.lens().begin(), idx.begin(), [](auto i, auto len) {
+        return len == 1 ? 0 : i;
+    });
+    return {row_shape(s, axes), a.data() + s.index(idx) * s.type_size()};
+}
+
+// Rewrite the submodule to compute a single row, with the pointwise modules
+// inlined so each operator is applied to the whole row at once
+static module make_row_module(const module& m,
+                              const std::vector<shape>& inputs,
+                              const std::vector<std::int64_t>& axes)
+{
+    module rm;
+    auto names = m.get_parameter_names();
+    std::sort(names.begin(), names.end());
+    std::unordered_map<instruction_ref, instruction_ref> map_ins;
+    for(auto i : range(names.size()))
+        map_ins[m.get_parameter(names[i])] = rm.add_parameter(names[i], row_shape(inputs[i], axes));
+    auto outputs = rm.add_instructions(
+        &m,
+        &map_ins,
+        [&](module& nm,
+            instruction_ref pos,
+            const operation& op,
+            const std::vector<instruction_ref>& xs,
+            const std::vector<module_ref>& mod_args) -> instruction_ref {
+            if(op.name() == "pointwise")
+            {
+                const auto* pm = mod_args.front();
+                auto lens      = xs.front()->get_shape().lens();
+                std::unordered_map<instruction_ref, instruction_ref> literal_map;
+                for(auto ins : iterator_for(*pm))
+                {
+                    if(ins->name() != "@literal")
+                        continue;
+                    literal_map[ins] = nm.insert_instruction(
+                        pos,
+                        make_op("multibroadcast", {{"out_lens", lens}}),
+                        nm.add_literal(ins->get_literal()));
+                }
+                return nm.insert_inline(pos, *pm, xs, &literal_map).front();
+            }
+            if(contains({"broadcast", "multibroadcast"}, op.name()))
+            {
+                auto v        = op.to_value();
+                v["out_lens"] = row_lens(v.at("out_lens").to_vector<std::size_t>(), axes);
+                return nm.insert_instruction(pos, make_op(op.name(), v), xs, mod_args);
+            }
+            return nm.insert_instruction(pos, op, xs, mod_args);
+        });
+    rm.add_return(outputs);
+    return rm;
+}
+
+// Evaluate the row module directly rather than through the evaluator of the
+// program, which traces and records every instruction it runs
+static argument eval_row_module(const module& rm,
+                                const std::unordered_map<std::string, argument>& params)
+{
+    std::unordered_map<instruction_ref, argument> results;
+    std::vector<argument> values;
+    for(auto ins : iterator_for(rm))
+    {
+        const auto& name = ins->name();
+        if(name == "@return")
+            return results.at(ins->inputs().front());
+        if(name == "@param")
+        {
+            results[ins] = params.at(any_cast<builtin::param>(ins->get_operator()).parameter);
+        }
+        else if(name == "@literal")
+        {
+            results[ins] = ins->get_literal().get_argument();
+        }
+        else
+        {
+            values.resize(ins->inputs().size());
+            std::transform(ins->inputs().begin(),
+                           ins->inputs().end(),
+                           values.begin(),
+                           [&](instruction_ref i) { return results.at(i); });
+            results[ins] = ins->normalized_operator().compute(ins->get_shape(), values);
+        }
+    }
+    MIGRAPHX_THROW("fused_reduce: row module has no return");
+}
+
+// Row modules already built for the fused_reduce submodules, so a submodule is
+// only rewritten once for each input shape
+struct row_module_cache
+{
+    struct entry
+    {
+        const_module_ref m;
+        std::vector<shape> inputs;
+        std::shared_ptr<const module> rm;
+    };
+    std::mutex mutex;
+    // Generation of the modules when the entries were last known to be valid
+    std::size_t generation = 0;
+    std::vector<entry> entries;
+
+    std::shared_ptr<const module> get(const_module_ref m,
+                                      const std::vector<shape>& inputs,
+                                      const std::vector<std::int64_t>& axes)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // Changing a module, or destroying it and creating another one at the
+        // same address, moves the generation, so the entries may be stale
+        if(generation != instruction::get_generation())
+            entries.clear();
+        auto it = std::find_if(entries.begin(), entries.end(), [&](const auto& e) {
+            return e.m == m and e.inputs == inputs;
+        });
+        if(it != entries.end())
+            return it->rm;
+        auto rm = std::make_shared<const module>(make_row_module(*m, inputs, axes));
+        entries.push_back({m, inputs, rm});
+        // Building the row module moved the generation, but did not change
+        // the modules the other entries were built from
+        generation = instruction::get_generation();
+        return rm;
+    }
+};
+
+static row_module_cache& get_row_module_cache()
+{
+    static row_module_cache cache;
+    return cache;
+}
+
 struct fused_reduce
 {
     std::vector<std::int64_t> axes{};
@@ -78,6 +235,34 @@ struct fused_reduce
     }
 
     std::string name() const { return "fused_reduce"; }
+
+    // Each output row is computed by evaluating the submodule on just the
+    // elements reduced into it, so the intermediate results stay in cache
+    argument compute(const shape& output_shape,
+                     const std::vector<argument>& args,
+                     const std::vector<module_ref>& mods,
+                     const std::function<std::vector<argument>(
+                         module_ref&, const std::unordered_map<std::string, argument>&)>&) const
+    {
+        argument result{output_shape};
+        auto names = mods.front()->get_parameter_names();
+        std::sort(names.begin(), names.end());
+        auto rm   = get_row_module_cache().get(mods.front(), to_shapes(args), axes);
+        auto lens = output_shape.lens();
+        for(auto axis : axes)
+            lens[axis] = 1;
+        shape outer{output_shape.type(), lens};
+        par_for(outer.elements(), 1, [&](auto i) {
+            auto idx = outer.multi(i);
+            std::unordered_map<std::string, argument> params;
+            for(auto j : range(args.size()))
+                params[names[j]] = get_row(args[j], idx, axes);
+            auto row = eval_row_module(*rm, params);
+            visit_all(get_row(result, idx, axes), row)(
+                [](auto y, auto x) { std::copy(x.begin(), x.end(), y.begin()); });
+        });
+        return result;
+    }
 };
 MIGRAPHX_REGISTER_OP(fused_reduce);
 
@@ -0,0 +1,144 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/group_dots.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/functional.hpp>
+#include <migraphx/ranges.hpp>
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <unordered_set>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// Instructions after pos that ins depends on, with inputs before their users
+static std::vector<instruction_ref>
+ancestors_after(const module& m, instruction_ref pos, instruction_ref ins)
+{
+    std::vector<instruction_ref> result;
+    std::unordered_set<instruction_ref> visited;
+    fix([&](auto self, instruction_ref x) -> void {
+        for(auto input : x->inputs())
+        {
+            if(not m.has_instruction(input) or m.precedes(input, pos))
+                continue;
+            if(not visited.insert(input).second)
+                continue;
+            self(input);
+            result.push_back(input);
+        }
+    })(ins);
+    return result;
+}
+
+static bool is_independent(const module& m,
+                           const std::vector<instruction_ref>& group,
+                           instruction_ref ins)
+{
+    auto ancestors = ancestors_after(m, group.front(), ins);
+    return std::none_of(ancestors.begin(), ancestors.end(), [&](auto x) {
+        return contains(group, x);
+    });
+}
+
+static void group_dot_instructions(module& m, const std::vector<instruction_ref>& group)
+{
+    auto pos = group.front();
+    // Move what the other dots depend on before the first one
+    for(auto ins : range(group.begin() + 1, group.end()))
+    {
+        for(auto x : ancestors_after(m, pos, ins))
+            m.move_instruction(x, pos);
+    }
+    std::vector<instruction_ref> as;
+    std::vector<instruction_ref> bs;
+    for(auto ins : group)
+    {
+        auto unsqueeze = make_op("unsqueeze", {{"axes", {0}}});
+        as.push_back(m.insert_instruction(pos, unsqueeze, ins->inputs()[0]));
+        bs.push_back(m.insert_instruction(pos, unsqueeze, ins->inputs()[1]));
+    }
+    auto a    = m.insert_instruction(pos, make_op("concat", {{"axis", 0}}), as);
+    auto b    = m.insert_instruction(pos, make_op("concat", {{"axis", 0}}), bs);
+    auto gemm = m.insert_instruction(pos, make_op("dot"), a, b);
+    for(std::size_t i = 0; i < group.size(); i++)
+    {
+        auto slice = m.insert_instruction(
+            pos, make_op("slice", {{"axes", {0}}, {"starts", {i}}, {"ends", {i + 1}}}), gemm);
+        auto squeeze = m.insert_instruction(pos, make_op("squeeze", {{"axes", {0}}}), slice);
+        m.replace_instruction(group[i], squeeze);
+    }
+}
+
+void group_dots::apply(module& m) const
+{
+    using key_type = std::tuple<shape::type_t, std::vector<std::size_t>, std::vector<std::size_t>>;
+    std::map<key_type, std::vector<std::vector<instruction_ref>>> groups;
+    for(auto ins : iterator_for(m))
+    {
+        if(ins->name() != "dot" or ins->get_shape().dynamic())
+            continue;
+        const auto& a = ins->inputs()[0]->get_shape();
+        const auto& b = ins->inputs()[1]->get_shape();
+        if(ins->get_shape().elements() * a.lens().back() >= max_gemm_size)
+            continue;
+        auto& candidates = groups[key_type{a.type(), a.lens(), b.lens()}];
+        auto it          = std::find_if(candidates.begin(), candidates.end(), [&](const auto& g) {
+            return is_independent(m, g, ins);
+        });
+        if(it == candidates.end())
+            candidates.push_back({ins});
+        else
+            it->push_back(ins);
+    }
+    for(auto& p : groups)
+    {
+        for(auto& group : p.second)
+        {
+            if(group.size() < 2)
+                continue;
+            // Grouping other dots may have moved these dots or made them depend
+            // on each other
+            std::sort(group.begin(), group.end(), [&](auto x, auto y) {
+                return m.precedes(x, y);
+            });
+            std::vector<instruction_ref> independent;
+            for(auto ins : group)
+            {
+                if(independent.empty() or is_independent(m, independent, ins))
+                    independent.push_back(ins);
+            }
+            if(independent.size() < 2)
+                continue;
+            group_dot_instructions(m, independent);
+        }
+    }
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
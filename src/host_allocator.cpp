@@ -0,0 +1,164 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/host_allocator.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_HOST_HUGE_PAGES)
+
+static char* default_allocate(std::size_t bytes, std::size_t alignment)
+{
+#ifdef _WIN32
+    return static_cast<char*>(_aligned_malloc(bytes, alignment));
+#else
+    void* ptr = nullptr;
+    if(posix_memalign(&ptr, alignment, bytes) != 0)
+        return nullptr;
+    return static_cast<char*>(ptr);
+#endif
+}
+
+static void default_deallocate(char* ptr, std::size_t, std::size_t)
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr); // NOLINT
+#endif
+}
+
+// Returns true when the kernel accepted the advice. This is only a hint, so
+// a failure is not an error.
+static bool advise_huge_pages(char* ptr, std::size_t bytes)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    return madvise(ptr, bytes, MADV_HUGEPAGE) == 0;
+#else
+    (void)ptr;
+    (void)bytes;
+    return false;
+#endif
+}
+
+struct host_allocator_state
+{
+    std::mutex m;
+    std::shared_ptr<const host_allocator> allocator =
+        std::make_shared<host_allocator>(host_allocator{&default_allocate, &default_deallocate});
+    std::atomic<std::size_t> bytes{0};
+    std::atomic<std::size_t> peak_bytes{0};
+    std::atomic<std::size_t> huge_page_bytes{0};
+    std::atomic<std::size_t> allocations{0};
+
+    std::shared_ptr<const host_allocator> get_allocator()
+    {
+        std::lock_guard<std::mutex> lock(m);
+        return allocator;
+    }
+
+    void add(std::size_t n, bool huge)
+    {
+        auto current = bytes += n;
+        auto peak    = peak_bytes.load();
+        while(current > peak and not peak_bytes.compare_exchange_weak(peak, current)) {}
+        if(huge)
+            huge_page_bytes += n;
+        allocations++;
+    }
+
+    void remove(std::size_t n, bool huge)
+    {
+        bytes -= n;
+        if(huge)
+            huge_page_bytes -= n;
+    }
+};
+
+// Buffers can outlive other static objects, so the state is never destroyed
+static host_allocator_state& get_state()
+{
+    static auto* state = new host_allocator_state{}; // NOLINT
+    return *state;
+}
+
+void set_host_allocator(host_allocator a)
+{
+    auto& state = get_state();
+    std::lock_guard<std::mutex> lock(state.m);
+    if(a.allocate == nullptr or a.deallocate == nullptr)
+        a = host_allocator{&default_allocate, &default_deallocate};
+    state.allocator = std::make_shared<host_allocator>(std::move(a));
+}
+
+std::shared_ptr<char> allocate_host_buffer(std::size_t bytes)
+{
+    auto& state    = get_state();
+    auto allocator = state.get_allocator();
+    bool huge = bytes >= host_huge_page_size and not enabled(MIGRAPHX_DISABLE_HOST_HUGE_PAGES{});
+    std::size_t alignment = huge ? host_huge_page_size : host_buffer_alignment;
+    std::size_t n         = std::max<std::size_t>(1, (bytes + alignment - 1) / alignment) * alignment;
+    char* ptr             = allocator->allocate(n, alignment);
+    if(ptr == nullptr)
+        MIGRAPHX_THROW("Failed to allocate " + std::to_string(bytes) + " bytes of host memory");
+    // Advise before touching the memory so the pages are backed by huge pages
+    bool advised = huge and advise_huge_pages(ptr, n);
+    std::memset(ptr, 0, n);
+    state.add(n, advised);
+    return {ptr, [allocator, n, alignment, advised](char* p) {
+                allocator->deallocate(p, n, alignment);
+                get_state().remove(n, advised);
+            }};
+}
+
+host_allocation_stats get_host_allocation_stats()
+{
+    auto& state = get_state();
+    host_allocation_stats result;
+    result.bytes           = state.bytes;
+    result.peak_bytes      = state.peak_bytes;
+    result.huge_page_bytes = state.huge_page_bytes;
+    result.allocations     = state.allocations;
+    return result;
+}
+
+void reset_host_allocation_peak()
+{
+    auto& state = get_state();
+    state.peak_bytes = state.bytes.load();
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
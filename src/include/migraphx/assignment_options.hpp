@@ -25,6 +25,7 @@
 #define MIGRAPHX_GUARD_RTGLIB_ASSIGNMENT_OPTIONS_HPP
 
 #include <migraphx/support_metric.hpp>
+#include <cstddef>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -32,6 +33,12 @@ inline namespace MIGRAPHX_INLINE_NS {
 struct assignment_options
 {
     support_metric metric = support_metric::latency;
+    // Estimated cost of moving one byte between two targets, in the same unit
+    // as the metric of the supported segments
+    float transfer_cost_per_byte = 0;
+    // Runs of fewer instructions than this are moved to a neighbouring target
+    // when it supports them, to avoid ping-ponging between targets
+    std::size_t min_segment_size = 1;
 };
 
 } // namespace MIGRAPHX_INLINE_NS
@@ -26,6 +26,7 @@
 
 #include <migraphx/config.hpp>
 #include <migraphx/tracer.hpp>
+#include <cstddef>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -41,6 +42,13 @@ struct compile_options
     bool fast_math       = true;
     bool exhaustive_tune = false;
 
+    /**
+     * Memory in bytes that compilation tries to stay under by skipping
+     * optimizations that need more memory, such as constant folds that
+     * produce literals larger than their inputs. Zero means no budget.
+     */
+    std::size_t memory_budget = 0;
+
     tracer trace{};
 };
 
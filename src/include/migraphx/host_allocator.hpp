@@ -0,0 +1,82 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHLIB_HOST_ALLOCATOR_HPP
+#define MIGRAPHX_GUARD_MIGRAPHLIB_HOST_ALLOCATOR_HPP
+
+#include <migraphx/config.hpp>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// Alignment of every host buffer, so SIMD kernels can use aligned loads
+constexpr std::size_t host_buffer_alignment = 64;
+/// Buffers at least this large are aligned to and advised as huge pages
+constexpr std::size_t host_huge_page_size = 2 * 1024 * 1024;
+
+/**
+ * @brief Allocation functions used for host buffers
+ * @details allocate returns memory of at least the requested size aligned to
+ * the requested alignment, and deallocate releases it given the same size and
+ * alignment. Memory does not need to be initialized.
+ */
+struct host_allocator
+{
+    std::function<char*(std::size_t bytes, std::size_t alignment)> allocate;
+    std::function<void(char* ptr, std::size_t bytes, std::size_t alignment)> deallocate;
+};
+
+struct host_allocation_stats
+{
+    /// Bytes currently allocated
+    std::size_t bytes = 0;
+    /// Largest number of bytes allocated at the same time
+    std::size_t peak_bytes = 0;
+    /// Bytes currently allocated in buffers the kernel accepted huge page advice for
+    std::size_t huge_page_bytes = 0;
+    /// Number of buffers allocated since the start of the process
+    std::size_t allocations = 0;
+};
+
+/// Replace the allocator used for host buffers. Buffers are always released
+/// with the allocator that created them. An empty allocator restores the
+/// default one.
+MIGRAPHX_EXPORT void set_host_allocator(host_allocator a);
+
+/// Allocate a zero-initialized host buffer aligned to host_buffer_alignment.
+/// Large buffers are aligned to host_huge_page_size and advised to use
+/// transparent huge pages.
+MIGRAPHX_EXPORT std::shared_ptr<char> allocate_host_buffer(std::size_t bytes);
+
+MIGRAPHX_EXPORT host_allocation_stats get_host_allocation_stats();
+
+/// Set the peak to the number of bytes currently allocated
+MIGRAPHX_EXPORT void reset_host_allocation_peak();
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
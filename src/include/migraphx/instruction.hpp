@@ -133,6 +133,11 @@ struct MIGRAPHX_EXPORT instruction
 
     static instruction_ref get_output_alias(instruction_ref ins, bool shallow = false);
 
+    /// Counter that is incremented on every change to an instruction or a
+    /// module, which is used to invalidate cached analyses
+    static std::size_t get_generation();
+    static void next_generation();
+
     void set_normalized(bool value = true);
     bool is_normalized() const;
 
@@ -182,6 +187,13 @@ struct MIGRAPHX_EXPORT instruction
     literal lit;
     bool normalized       = false;
     std::size_t target_id = 0;
+    // Increasing label of the position in the module, maintained by the module
+    std::size_t order = 0;
+    // Position in the module, only valid until the module is changed
+    std::size_t index = 0;
+
+    friend struct module_impl;
+    friend struct replace_shape_order;
 };
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
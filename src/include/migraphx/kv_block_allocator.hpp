@@ -0,0 +1,84 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_KV_BLOCK_ALLOCATOR_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_KV_BLOCK_ALLOCATOR_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/argument.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/**
+ * Manages the blocks of a paged kv-cache used by paged_concat_past_present
+ * and paged_attention. Sequences are identified by an id chosen by the
+ * caller, and grow one block at a time so many sequences of different
+ * lengths can share a cache of fixed size.
+ */
+struct MIGRAPHX_EXPORT kv_block_allocator
+{
+    kv_block_allocator() = default;
+    kv_block_allocator(std::size_t num_blocks, std::size_t block_size);
+
+    std::size_t num_blocks() const;
+    std::size_t block_size() const;
+    std::size_t free_blocks() const;
+
+    /// Append n tokens to the sequence, allocating the blocks needed. Returns
+    /// false without changing anything when there are not enough free blocks.
+    /// Throws when n is 0.
+    bool append(std::size_t seq_id, std::size_t n = 1);
+    /// Return the blocks of the sequence to the free list
+    void release(std::size_t seq_id);
+
+    bool contains(std::size_t seq_id) const;
+    std::size_t sequence_length(std::size_t seq_id) const;
+    const std::vector<std::int32_t>& blocks(std::size_t seq_id) const;
+
+    /// Block table of the sequences as a (batch_size, max_blocks) int32 argument,
+    /// unused entries are set to -1
+    argument make_block_table(const std::vector<std::size_t>& seq_ids,
+                              std::size_t max_blocks) const;
+    /// Sequence lengths minus one of the sequences as a (batch_size) int32 argument
+    argument make_seqlens_k(const std::vector<std::size_t>& seq_ids) const;
+
+    private:
+    struct sequence
+    {
+        std::vector<std::int32_t> blocks;
+        std::size_t length = 0;
+    };
+    const sequence& get_sequence(std::size_t seq_id) const;
+    std::size_t m_block_size = 0;
+    std::size_t m_num_blocks = 0;
+    std::vector<std::int32_t> free_list;
+    std::unordered_map<std::size_t, sequence> sequences;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+#endif // MIGRAPHX_GUARD_MIGRAPHX_KV_BLOCK_ALLOCATOR_HPP
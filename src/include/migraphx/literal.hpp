@@ -32,6 +32,7 @@
 #include <migraphx/make_shared_array.hpp>
 #include <migraphx/config.hpp>
 
+#include <atomic>
 #include <memory>
 
 namespace migraphx {
@@ -97,6 +98,19 @@ struct literal : raw_data<literal>
 
     std::vector<literal> get_sub_objects() const { return {}; }
 
+    /// Hash of the shape and the raw bytes of the data, which is computed once
+    /// and then cached
+    MIGRAPHX_EXPORT friend std::size_t hash_value(const literal& l);
+
+    /// Compares the elements, literals sharing a buffer are equal without
+    /// reading the data
+    MIGRAPHX_EXPORT friend bool operator==(const literal& x, const literal& y);
+    friend bool operator!=(const literal& x, const literal& y) { return not(x == y); }
+
+    /// Returns a literal that shares its buffer with a previously interned
+    /// literal of the same shape and data, or interns this one
+    MIGRAPHX_EXPORT friend literal intern_literal(const literal& l);
+
     /// Convert the data to an argument
     argument get_argument() const
     {
@@ -105,8 +119,22 @@ struct literal : raw_data<literal>
     }
 
     private:
+    // Content hash computed on first use, zero when it is not computed yet
+    struct cached_hash
+    {
+        cached_hash() = default;
+        cached_hash(const cached_hash& rhs) : data(rhs.data.load()) {}
+        cached_hash& operator=(const cached_hash& rhs)
+        {
+            data = rhs.data.load();
+            return *this;
+        }
+        mutable std::atomic<std::size_t> data{0};
+    };
+
     std::shared_ptr<char> buffer;
     shape m_shape;
+    cached_hash m_hash;
 
     // Keeps the same data ordering as the given container
     template <class Iterator>
@@ -147,6 +175,9 @@ literal transform(literal l1, literal l2, F f)
     return result;
 }
 
+MIGRAPHX_EXPORT std::size_t hash_value(const literal& l);
+MIGRAPHX_EXPORT literal intern_literal(const literal& l);
+
 MIGRAPHX_EXPORT void migraphx_to_value(value& v, const literal& l);
 MIGRAPHX_EXPORT void migraphx_from_value(const value& v, literal& l);
 
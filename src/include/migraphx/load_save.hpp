@@ -34,6 +34,8 @@ inline namespace MIGRAPHX_INLINE_NS {
 struct file_options
 {
     std::string format = "msgpack";
+    // Share the buffers of loaded literals with other programs that have the same data
+    bool intern_literals = false;
 };
 
 MIGRAPHX_EXPORT program load(const std::string& filename,
@@ -25,7 +25,9 @@
 #define MIGRAPHX_GUARD_MIGRAPHLIB_MAKE_SHARED_ARRAY_HPP
 
 #include <memory>
+#include <type_traits>
 #include <migraphx/config.hpp>
+#include <migraphx/host_allocator.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -33,8 +35,18 @@ inline namespace MIGRAPHX_INLINE_NS {
 template <typename T>
 std::shared_ptr<T> make_shared_array(size_t size)
 {
-    // cppcheck-suppress migraphx-UseSmartPointer
-    return std::shared_ptr<T>(new T[size](), std::default_delete<T[]>()); // NOLINT
+    if constexpr(std::is_trivially_default_constructible<T>{} and
+                 std::is_trivially_destructible<T>{})
+    {
+        // Zero-initialized memory from the host allocator is a valid array of T
+        auto buffer = allocate_host_buffer(size * sizeof(T));
+        return std::shared_ptr<T>(buffer, reinterpret_cast<T*>(buffer.get())); // NOLINT
+    }
+    else
+    {
+        // cppcheck-suppress migraphx-UseSmartPointer
+        return std::shared_ptr<T>(new T[size](), std::default_delete<T[]>()); // NOLINT
+    }
 }
 
 template <class T, class Iterator>
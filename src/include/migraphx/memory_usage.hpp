@@ -0,0 +1,66 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHLIB_MEMORY_USAGE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHLIB_MEMORY_USAGE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/instruction_ref.hpp>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// Memory needed to evaluate a module, in bytes
+struct module_memory_usage
+{
+    std::string name;
+    std::size_t literal_bytes   = 0;
+    std::size_t parameter_bytes = 0;
+    std::size_t output_bytes    = 0;
+    std::size_t scratch_bytes   = 0;
+    /// Allocations that are not part of the scratch memory
+    std::size_t allocation_bytes = 0;
+    /// Largest set of results (including allocations) alive at the same time
+    std::size_t peak_live_bytes = 0;
+    /// Results alive when peak_live_bytes is reached, largest first
+    std::vector<instruction_ref> peak_live_instructions;
+};
+
+struct MIGRAPHX_EXPORT memory_usage
+{
+    std::vector<module_memory_usage> modules;
+    /// Bytes of the literals of all modules, counting shared buffers once
+    std::size_t literal_bytes = 0;
+
+    /// Upper bound of the memory used by an evaluation: the literals, the
+    /// parameters and outputs of the main module (the first one), and the
+    /// scratch memory and peak live results of every module
+    std::size_t total_bytes() const;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -46,6 +46,7 @@ MIGRAPHX_EXPORT
 const operation& get_operation(instruction_ref ins);
 
 struct module_impl;
+struct dominator_info;
 
 using parameter_map = std::unordered_map<std::string, argument>;
 using ins_dep_map   = std::unordered_map<instruction_ref, std::unordered_set<instruction_ref>>;
@@ -202,6 +203,15 @@ struct MIGRAPHX_EXPORT module
     instruction_ref begin() const;
     instruction_ref end() const;
 
+    /// Dense position of the instruction in the module, from 0 to size() - 1,
+    /// so analyses can store per-instruction data in a vector. The positions
+    /// are recomputed on the first call after the module is changed.
+    std::size_t get_index(instruction_ref ins) const;
+
+    /// Returns true when x comes before y in the module. This takes constant
+    /// time and does not need the positions to be recomputed.
+    bool precedes(instruction_ref x, instruction_ref y) const;
+
     struct compute_shapes_options
     {
         std::string name                               = "compute_shapes";
@@ -324,6 +334,12 @@ struct MIGRAPHX_EXPORT module
      */
     ins_dep_map calc_implicit_deps() const;
 
+    /// The analyses below are computed on first use and cached until any
+    /// module or instruction is changed, so passes that run repeatedly
+    /// without changing the module do not recompute them.
+    const dominator_info& get_dominator_info() const;
+    const ins_dep_map& get_implicit_deps() const;
+
     void repeat_while_changes(std::size_t n, const std::function<void()>& f);
 
     MIGRAPHX_EXPORT friend std::ostream& operator<<(std::ostream& os, const module& m);
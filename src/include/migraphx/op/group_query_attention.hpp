@@ -532,9 +532,10 @@ struct group_query_attention
                                          pos_ids.data(),
                                          gqa_params);
                 }
-                auto v_input         = k_input + kv_num_heads * sequence_length * head_size;
-                auto v_rotary        = k_rotary + kv_num_heads * sequence_length * head_size;
-                gqa_params.num_heads = num_heads;
+                auto v_input           = k_input + kv_num_heads * sequence_length * head_size;
+                auto v_rotary          = k_rotary + kv_num_heads * sequence_length * head_size;
+                gqa_params.num_heads   = num_heads;
+                gqa_params.hidden_size = q_hidden_size;
 
                 if(do_rotary)
                 {
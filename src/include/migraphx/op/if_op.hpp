@@ -30,8 +30,8 @@
 #include <migraphx/config.hpp>
 #include <migraphx/module.hpp>
 #include <cmath>
+#include <algorithm>
 #include <utility>
-#include <set>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -68,21 +68,22 @@ struct if_op
     {
         auto cond      = args.front().at<bool>();
         module_ref mod = cond ? mods[0] : mods[1];
-        std::unordered_map<std::string, argument> params;
-
-        std::set<std::string> pnames;
+        // Parameters of both branches are bound, in sorted order, to the
+        // arguments after the condition
+        std::vector<std::string> pnames;
         for(const_module_ref smod : mods)
         {
             auto names = smod->get_parameter_names();
-            pnames.insert(names.begin(), names.end());
+            pnames.insert(pnames.end(), names.begin(), names.end());
         }
+        std::sort(pnames.begin(), pnames.end());
+        pnames.erase(std::unique(pnames.begin(), pnames.end()), pnames.end());
 
         assert(pnames.size() < args.size());
-        std::transform(pnames.begin(),
-                       pnames.end(),
-                       args.begin() + 1,
-                       std::inserter(params, params.end()),
-                       [](auto&& name, auto&& arg) { return std::make_pair(name, arg); });
+        std::unordered_map<std::string, argument> params;
+        params.reserve(pnames.size());
+        for(std::size_t i = 0; i < pnames.size(); ++i)
+            params.emplace(std::move(pnames[i]), args[i + 1]);
 
         auto results = run(mod, params);
         return argument{results};
@@ -43,12 +43,16 @@ struct loop
 {
     int64_t max_iterations                      = 10;
     std::vector<int64_t> scan_output_directions = {};
+    // Return scan outputs with the number of iterations actually run as the
+    // leading dimension, rather than zero-filling them up to max_iterations
+    bool trim_scan_outputs = false;
 
     template <class Self, class F>
     static auto reflect(Self& self, F f)
     {
         return pack(f(self.max_iterations, "max_iterations"),
-                    f(self.scan_output_directions, "scan_output_directions"));
+                    f(self.scan_output_directions, "scan_output_directions"),
+                    f(self.trim_scan_outputs, "trim_scan_outputs"));
     }
 
     std::string name() const { return "loop"; }
@@ -73,9 +77,18 @@ struct loop
         mod_out_shapes.erase(mod_out_shapes.begin(), mod_out_shapes.begin() + dep_param_num);
         for(const auto& out_s : mod_out_shapes)
         {
-            auto lens = out_s.lens();
-            lens.insert(lens.begin(), max_iterations);
-            ins_out_shapes.push_back({out_s.type(), lens});
+            if(trim_scan_outputs)
+            {
+                auto dims = out_s.to_dynamic().dyn_dims();
+                dims.insert(dims.begin(), {0, static_cast<std::size_t>(max_iterations)});
+                ins_out_shapes.push_back({out_s.type(), dims});
+            }
+            else
+            {
+                auto lens = out_s.lens();
+                lens.insert(lens.begin(), max_iterations);
+                ins_out_shapes.push_back({out_s.type(), lens});
+            }
         }
 
         return shape(ins_out_shapes);
@@ -84,6 +97,7 @@ struct loop
     struct ref_loop
     {
         int64_t max_iterations = 0;
+        bool trim_scan_outputs = false;
 
         template <class T>
         void copy(context&, const argument& src, T& dst) const
@@ -113,10 +127,13 @@ struct loop
                 auto idx = (1 - dir) * curr_iter + dir * (num_iters - 1 - curr_iter);
 
                 auto* in_data        = iter_stat.data();
-                auto* out_data       = scan_out.data();
                 std::size_t out_size = iter_stat.get_shape().bytes();
+                auto* out_data       = scan_out.data() + idx * out_size;
                 assert((idx + 1) * out_size <= scan_out.get_shape().bytes());
-                std::copy(in_data, in_data + out_size, out_data + idx * out_size);
+                // The body already wrote this output through its output parameter
+                if(in_data == out_data)
+                    continue;
+                std::copy(in_data, in_data + out_size, out_data);
             }
         }
 
@@ -133,7 +150,10 @@ struct loop
             }
         }
 
-        std::unordered_map<std::string, int> get_output_params(const module&) const { return {}; }
+        std::unordered_map<std::string, int> get_output_params(const module& m) const
+        {
+            return get_loop_output_params(m);
+        }
     };
 
     argument compute(context& ctx,
@@ -153,14 +173,37 @@ struct loop
         auto s_iter = args.at(0).get_shape();
         cpy_args.push_back({s_iter, &iter});
         cpy_args.push_back({s_cond, &cond});
-        cpy_args.insert(cpy_args.end(), args.begin() + 2, args.end());
-
-        // add cond and mod outputs to the argument list
+        // A body with output parameters writes the carried state of the first
+        // iteration into these buffers, so they must not alias the inputs
+        if(get_loop_output_params(*mods.front()).empty())
+            cpy_args.insert(cpy_args.end(), args.begin() + 2, args.end());
+        else
+            std::transform(args.begin() + 2,
+                           args.end(),
+                           std::back_inserter(cpy_args),
+                           [](const argument& a) { return argument{a.get_shape()}; });
+
+        // add cond and mod outputs to the argument list, trimmed scan outputs
+        // are allocated for max_iterations
+        std::vector<shape> alloc_shapes;
+        std::transform(out_shape.sub_shapes().begin(),
+                       out_shape.sub_shapes().end(),
+                       std::back_inserter(alloc_shapes),
+                       [](const shape& s) {
+                           if(not s.dynamic())
+                               return s;
+                           return shape{s.type(), s.max_lens()};
+                       });
         cpy_args.push_back(argument(s_cond));
-        cpy_args.push_back(argument(out_shape));
+        cpy_args.push_back(argument(shape{alloc_shapes}));
 
         // run loop
-        return run_loop(ref_loop{max_iterations}, scan_output_directions, ctx, cpy_args, mods, run);
+        return run_loop(ref_loop{max_iterations, trim_scan_outputs},
+                        scan_output_directions,
+                        ctx,
+                        cpy_args,
+                        mods,
+                        run);
     }
 };
 
@@ -24,6 +24,7 @@
 #ifndef MIGRAPHX_GUARD_OPERATORS_NONMAXSUPPRESSION_HPP
 #define MIGRAPHX_GUARD_OPERATORS_NONMAXSUPPRESSION_HPP
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <queue>
@@ -39,6 +40,7 @@
 #include <migraphx/output_iterator.hpp>
 #include <migraphx/argument.hpp>
 #include <migraphx/par.hpp>
+#include <migraphx/par_for.hpp>
 
 /*
 https://github.com/onnx/onnx/blob/main/docs/Operators.md#NonMaxSuppression
@@ -281,34 +283,46 @@ struct nonmaxsuppression
     filter_boxes_by_score(T scores_start, std::size_t num_boxes, double score_threshold) const
     {
         std::vector<std::pair<double, int64_t>> boxes_heap;
-        int64_t box_idx = 0;
-
-        if(score_threshold > 0.0)
+        boxes_heap.reserve(num_boxes);
+        for(auto i : range(num_boxes))
         {
-            transform_if(
-                scores_start,
-                scores_start + num_boxes,
-                std::back_inserter(boxes_heap),
-                [&](auto sc) {
-                    box_idx++;
-                    return sc >= score_threshold;
-                },
-                [&](auto sc) { return std::make_pair(sc, box_idx - 1); });
-        }
-        else
-        { // score is irrelevant, just push into boxes_heap and make a score-index pair
-            std::transform(scores_start,
-                           scores_start + num_boxes,
-                           std::back_inserter(boxes_heap),
-                           [&](auto sc) {
-                               box_idx++;
-                               return std::make_pair(sc, box_idx - 1);
-                           });
+            double sc = scores_start[i];
+            // score is irrelevant when the threshold is not positive
+            if(score_threshold <= 0.0 or sc >= score_threshold)
+                boxes_heap.emplace_back(sc, i);
         }
-        par_sort(boxes_heap.begin(), boxes_heap.end(), std::greater<std::pair<double, int64_t>>{});
+        // the top scorer, with the higher index on ties, is at the front
+        std::make_heap(boxes_heap.begin(), boxes_heap.end());
         return boxes_heap;
     }
 
+    // Greedily select the top scoring boxes that do not overlap a box selected
+    // before. Candidates are popped from a heap, so only the boxes that are
+    // visited before max_output_boxes_per_class are selected get ordered.
+    std::vector<int64_t> select_boxes(std::vector<std::pair<double, int64_t>> boxes_heap,
+                                      const box* batch_boxes,
+                                      std::size_t max_output_boxes_per_class,
+                                      double iou_threshold) const
+    {
+        std::vector<int64_t> selected;
+        std::vector<box> selected_boxes;
+        auto last = boxes_heap.end();
+        while(last != boxes_heap.begin() and selected.size() < max_output_boxes_per_class)
+        {
+            std::pop_heap(boxes_heap.begin(), last);
+            --last;
+            auto box_idx        = last->second;
+            const auto& iou_box = batch_boxes[box_idx];
+            if(std::any_of(selected_boxes.begin(), selected_boxes.end(), [&](const auto& b) {
+                   return this->suppress_by_iou(iou_box, b, iou_threshold);
+               }))
+                continue;
+            selected.push_back(box_idx);
+            selected_boxes.push_back(iou_box);
+        }
+        return selected;
+    }
+
     template <class Output, class Boxes, class Scores>
     std::size_t compute_nms(Output output,
                             Boxes boxes,
@@ -322,50 +336,31 @@ struct nonmaxsuppression
         const auto num_batches = lens[0];
         const auto num_classes = lens[1];
         const auto num_boxes   = lens[2];
-        // boxes of a class with NMS applied [score, index]
-        std::vector<int64_t> selected_indices;
-        // iterate over batches and classes
-        shape comp_s{shape::double_type, {num_batches, num_classes}};
-        shape_for_each(comp_s, [&](const auto& idx) {
-            auto batch_idx = idx[0];
-            auto class_idx = idx[1];
-            // index offset for this class
-            auto scores_start = scores.begin() + (batch_idx * num_classes + class_idx) * num_boxes;
-            // iterator to first value of this batch
-            auto batch_boxes_start = boxes.begin() + batch_idx * num_boxes * 4;
-            auto boxes_heap = filter_boxes_by_score(scores_start, num_boxes, score_threshold);
-            int64_t selected_boxes_inside_class = 0;
-            while(not boxes_heap.empty() &&
-                  selected_boxes_inside_class < max_output_boxes_per_class)
+        // decode the boxes once since they are shared by all the classes of a batch
+        std::vector<box> all_boxes(num_batches * num_boxes);
+        par_for(all_boxes.size(), [&](auto i) { all_boxes[i] = batch_box(boxes.begin(), i); });
+        // boxes selected for each (batch, class) pair, which are independent
+        std::vector<std::vector<int64_t>> selected(num_batches * num_classes);
+        par_for(selected.size(), [&](auto i) {
+            auto scores_start      = scores.begin() + i * num_boxes;
+            const box* batch_boxes = all_boxes.data() + (i / num_classes) * num_boxes;
+            selected[i] =
+                select_boxes(filter_boxes_by_score(scores_start, num_boxes, score_threshold),
+                             batch_boxes,
+                             max_output_boxes_per_class,
+                             iou_threshold);
+        });
+        auto out = output.begin();
+        for(auto i : range(selected.size()))
+        {
+            for(auto box_idx : selected[i])
             {
-                // select next top scorer box and remove any boxes from boxes_heap that exceeds IOU
-                // threshold with the selected box
-                const auto next_top_score = boxes_heap.front();
-                auto next_box             = batch_box(batch_boxes_start, next_top_score.second);
-                auto next_box_idx         = next_top_score.second;
-
-                selected_boxes_inside_class++;
-                selected_indices.push_back(batch_idx);
-                selected_indices.push_back(class_idx);
-                selected_indices.push_back(next_box_idx);
-
-                std::vector<std::pair<double, int64_t>> remainder_boxes(boxes_heap.size());
-
-                auto it = par_copy_if(
-                    boxes_heap.begin() + 1,
-                    boxes_heap.end(),
-                    remainder_boxes.begin(),
-                    [&](auto iou_candidate_box) {
-                        auto iou_box = batch_box(batch_boxes_start, iou_candidate_box.second);
-                        return not this->suppress_by_iou(iou_box, next_box, iou_threshold);
-                    });
-
-                remainder_boxes.resize(it - remainder_boxes.begin());
-                boxes_heap = remainder_boxes;
+                *out++ = i / num_classes;
+                *out++ = i % num_classes;
+                *out++ = box_idx;
             }
-        });
-        std::copy(selected_indices.begin(), selected_indices.end(), output.begin());
-        return selected_indices.size() / 3;
+        }
+        return (out - output.begin()) / 3;
     }
 
     argument compute(const shape& output_shape, std::vector<argument> args) const
@@ -24,13 +24,14 @@
 #ifndef MIGRAPHX_GUARD_OPERATORS_NONZERO_HPP
 #define MIGRAPHX_GUARD_OPERATORS_NONZERO_HPP
 
-#include <migraphx/shape_for_each.hpp>
 #include <migraphx/check_shapes.hpp>
 #include <migraphx/config.hpp>
 #include <migraphx/float_equal.hpp>
 #include <migraphx/par_for.hpp>
 #include <migraphx/argument.hpp>
+#include <algorithm>
 #include <cmath>
+#include <numeric>
 #include <utility>
 
 namespace migraphx {
@@ -53,25 +54,43 @@ struct nonzero
 
     argument compute(const shape& output_shape, std::vector<argument> args) const
     {
-        std::vector<std::vector<std::size_t>> vec_idx;
-        auto s = args.front().get_shape();
-        args.front().visit([&](auto v) {
-            shape_for_each(s, [&](const auto& idx_v, size_t idx) {
-                if(not float_equal(v[idx], 0))
-                {
-                    vec_idx.push_back(idx_v);
-                }
-            });
-        });
-
         argument result{output_shape};
-        result.visit([&](auto output) {
-            std::fill(output.begin(), output.end(), 0);
-            par_for(vec_idx.size(), [&](auto i) {
-                for(std::size_t j = 0; j < vec_idx.front().size(); ++j)
-                {
-                    output[output_shape.index({j, i})] = vec_idx[i][j];
-                }
+        const auto& lens       = args.front().get_shape().lens();
+        std::size_t elements   = args.front().get_shape().elements();
+        std::size_t block_size = 4096;
+        std::size_t num_blocks = (elements + block_size - 1) / block_size;
+        // Count the nonzeros of each block, scan the counts to get the output
+        // position of each block, then write the indices of all blocks in parallel
+        std::vector<std::size_t> offsets(num_blocks + 1, 0);
+        args.front().visit([&](auto input) {
+            const auto* data = input.data();
+            par_for(num_blocks, [&](auto b) {
+                auto start = b * block_size;
+                auto end   = std::min(start + block_size, elements);
+                offsets[b + 1] = std::count_if(
+                    data + start, data + end, [](auto x) { return not float_equal(x, 0); });
+            });
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+            result.visit([&](auto output) {
+                std::fill(output.begin(), output.end(), 0);
+                auto* out = output.data();
+                par_for(num_blocks, [&](auto b) {
+                    auto pos   = offsets[b];
+                    auto start = b * block_size;
+                    auto end   = std::min(start + block_size, elements);
+                    for(auto i = start; i < end; i++)
+                    {
+                        if(float_equal(data[i], 0))
+                            continue;
+                        std::size_t idx = i;
+                        for(auto j = lens.size(); j > 0; j--)
+                        {
+                            out[(j - 1) * elements + pos] = idx % lens[j - 1];
+                            idx /= lens[j - 1];
+                        }
+                        pos++;
+                    }
+                });
             });
         });
 
@@ -0,0 +1,191 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_OPERATORS_PAGED_ATTENTION_HPP
+#define MIGRAPHX_GUARD_OPERATORS_PAGED_ATTENTION_HPP
+
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/config.hpp>
+#include <migraphx/par_for.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace op {
+
+/**
+ * Causal grouped-query attention that reads the keys and values from a
+ * block-paged kv-cache written by paged_concat_past_present.
+ *
+ * Inputs:
+ *   query       (batch_size, sequence_length, num_heads * head_size)
+ *   key_cache   (num_blocks, kv_num_heads, block_size, head_size)
+ *   value_cache (num_blocks, kv_num_heads, block_size, head_size)
+ *   block_table (batch_size, max_blocks_per_sequence)
+ *   seqlens_k   (batch_size), total sequence length minus one
+ */
+struct paged_attention
+{
+    std::size_t num_heads    = 1;
+    std::size_t kv_num_heads = 1;
+    int local_window_size    = -1;
+    float scale              = 0.0;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.num_heads, "num_heads"),
+                    f(self.kv_num_heads, "kv_num_heads"),
+                    f(self.local_window_size, "local_window_size"),
+                    f(self.scale, "scale"));
+    }
+
+    std::string name() const { return "paged_attention"; }
+
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        check_shapes{inputs, *this}.has(5).standard();
+        const auto& query       = inputs[0];
+        const auto& key_cache   = inputs[1];
+        const auto& block_table = inputs[3];
+        const auto& seqlens_k   = inputs[4];
+        check_shapes{{query}, *this}.only_dims(3);
+        check_shapes{{key_cache, inputs[2]}, *this}.only_dims(4).same_dims().same_type();
+        check_shapes{{block_table}, *this}.only_dims(2);
+        check_shapes{{seqlens_k}, *this}.only_dims(1);
+        if(kv_num_heads == 0 or num_heads % kv_num_heads != 0)
+            MIGRAPHX_THROW("PAGED_ATTENTION: num_heads must be a multiple of kv_num_heads");
+        if(key_cache.lens()[1] != kv_num_heads)
+            MIGRAPHX_THROW("PAGED_ATTENTION: kv-cache does not have kv_num_heads heads");
+        if(query.lens()[2] != num_heads * key_cache.lens()[3])
+            MIGRAPHX_THROW("PAGED_ATTENTION: query hidden size does not match head size");
+        if(query.type() != key_cache.type())
+            MIGRAPHX_THROW("PAGED_ATTENTION: query and kv-cache types do not match");
+        if(block_table.lens()[0] != query.lens()[0] or seqlens_k.lens()[0] != query.lens()[0])
+            MIGRAPHX_THROW("PAGED_ATTENTION: batch size of the block table and sequence lengths "
+                           "must match query");
+        return {query.type(), query.lens()};
+    }
+
+    argument compute(const shape& output_shape, std::vector<argument> args) const
+    {
+        argument result{output_shape};
+        auto q_lens            = args[0].get_shape().lens();
+        auto cache_lens        = args[1].get_shape().lens();
+        std::size_t batch_size = q_lens[0];
+        std::size_t seq_len    = q_lens[1];
+        std::size_t num_blocks = cache_lens[0];
+        std::size_t block_size = cache_lens[2];
+        std::size_t head_size  = cache_lens[3];
+        std::size_t max_blocks = args[3].get_shape().lens()[1];
+        std::size_t group      = num_heads / kv_num_heads;
+        double alpha = scale == 0.0f ? 1.0 / std::sqrt(static_cast<double>(head_size)) : scale;
+
+        std::vector<std::size_t> total_lens(batch_size);
+        std::vector<std::size_t> blocks(batch_size * max_blocks);
+        args[3].visit([&](auto block_table) {
+            args[4].visit([&](auto seqlens_k) {
+                for(std::size_t b = 0; b < batch_size; ++b)
+                {
+                    auto seqlen = static_cast<int64_t>(seqlens_k[b]);
+                    if(seqlen < 0)
+                        MIGRAPHX_THROW("PAGED_ATTENTION: invalid sequence length");
+                    std::size_t total = seqlen + 1;
+                    if(total < seq_len or (total + block_size - 1) / block_size > max_blocks)
+                        MIGRAPHX_THROW("PAGED_ATTENTION: invalid sequence length");
+                    total_lens[b] = total;
+                    for(std::size_t i = 0; i < (total + block_size - 1) / block_size; ++i)
+                    {
+                        auto block = static_cast<int64_t>(block_table[b * max_blocks + i]);
+                        if(block < 0 or block >= static_cast<int64_t>(num_blocks))
+                            MIGRAPHX_THROW("PAGED_ATTENTION: block index out of range");
+                        blocks[b * max_blocks + i] = block;
+                    }
+                }
+            });
+        });
+
+        visit_all(result, args[0], args[1], args[2])(
+            [&](auto output, auto query, auto key_cache, auto value_cache) {
+                par_for(batch_size * seq_len * num_heads, [&](auto i) {
+                    std::size_t n = i % num_heads;
+                    std::size_t s = (i / num_heads) % seq_len;
+                    std::size_t b = i / (num_heads * seq_len);
+                    std::size_t h = n / group;
+                    // Each query attends to every token up to and including itself
+                    std::size_t causal_len = total_lens[b] - seq_len + s + 1;
+                    std::size_t start      = 0;
+                    if(local_window_size > 0 and causal_len > std::size_t(local_window_size) + 1)
+                        start = causal_len - local_window_size - 1;
+
+                    auto token = [&](std::size_t t) {
+                        std::size_t block = blocks[b * max_blocks + t / block_size];
+                        return ((block * kv_num_heads + h) * block_size + t % block_size) *
+                               head_size;
+                    };
+                    auto q = query.begin() + i * head_size;
+                    std::vector<double> probs(causal_len - start);
+                    double max_score = std::numeric_limits<double>::lowest();
+                    for(std::size_t t = start; t < causal_len; ++t)
+                    {
+                        auto k       = key_cache.begin() + token(t);
+                        double score = 0;
+                        for(std::size_t d = 0; d < head_size; ++d)
+                            score += double(q[d]) * double(k[d]);
+                        probs[t - start] = alpha * score;
+                        max_score        = std::max(max_score, probs[t - start]);
+                    }
+                    double sum = 0;
+                    for(auto& p : probs)
+                    {
+                        p = std::exp(p - max_score);
+                        sum += p;
+                    }
+                    std::vector<double> acc(head_size);
+                    for(std::size_t t = start; t < causal_len; ++t)
+                    {
+                        auto v   = value_cache.begin() + token(t);
+                        double p = probs[t - start] / sum;
+                        for(std::size_t d = 0; d < head_size; ++d)
+                            acc[d] += p * double(v[d]);
+                    }
+                    using type = typename decltype(output)::value_type;
+                    std::transform(
+                        acc.begin(), acc.end(), output.begin() + i * head_size, [](auto x) {
+                            return static_cast<type>(x);
+                        });
+                });
+            });
+        return result;
+    }
+};
+
+} // namespace op
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -0,0 +1,130 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_OPERATORS_PAGED_CONCAT_PAST_PRESENT_HPP
+#define MIGRAPHX_GUARD_OPERATORS_PAGED_CONCAT_PAST_PRESENT_HPP
+
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/config.hpp>
+#include <migraphx/par_for.hpp>
+#include <algorithm>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace op {
+
+/**
+ * Writes the present keys or values into a block-paged kv-cache.
+ *
+ * Inputs:
+ *   cache       (num_blocks, kv_num_heads, block_size, head_size)
+ *   present     (batch_size, kv_num_heads, sequence_length, head_size)
+ *   block_table (batch_size, max_blocks_per_sequence), block indices of each sequence
+ *   seqlens_k   (batch_size), total sequence length minus one after appending present
+ *
+ * Token t of sequence b is stored at block block_table[b][t / block_size], row
+ * t % block_size. The cache is updated in place and returned.
+ */
+struct paged_concat_past_present
+{
+    std::string name() const { return "paged_concat_past_present"; }
+
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        check_shapes{inputs, *this}.has(4).standard();
+        const auto& cache       = inputs[0];
+        const auto& present     = inputs[1];
+        const auto& block_table = inputs[2];
+        const auto& seqlens_k   = inputs[3];
+        check_shapes{{cache, present}, *this}.only_dims(4).same_type();
+        check_shapes{{block_table}, *this}.only_dims(2);
+        check_shapes{{seqlens_k}, *this}.only_dims(1);
+        if(cache.lens()[1] != present.lens()[1] or cache.lens()[3] != present.lens()[3])
+            MIGRAPHX_THROW("PAGED_CONCAT_PAST_PRESENT: number of heads and head size of the "
+                           "cache and present do not match");
+        if(block_table.lens()[0] != present.lens()[0] or
+           seqlens_k.lens()[0] != present.lens()[0])
+            MIGRAPHX_THROW("PAGED_CONCAT_PAST_PRESENT: batch size of the block table and "
+                           "sequence lengths must match present");
+        return cache;
+    }
+
+    argument compute(const shape&, std::vector<argument> args) const
+    {
+        auto cache_lens         = args[0].get_shape().lens();
+        auto present_lens       = args[1].get_shape().lens();
+        std::size_t num_blocks  = cache_lens[0];
+        std::size_t kv_heads    = cache_lens[1];
+        std::size_t block_size  = cache_lens[2];
+        std::size_t head_size   = cache_lens[3];
+        std::size_t batch_size  = present_lens[0];
+        std::size_t seq_len     = present_lens[2];
+        std::size_t max_blocks  = args[2].get_shape().lens()[1];
+        std::vector<std::size_t> past_lens(batch_size);
+        std::vector<std::size_t> blocks(batch_size * max_blocks);
+        args[2].visit([&](auto block_table) {
+            args[3].visit([&](auto seqlens_k) {
+                for(std::size_t b = 0; b < batch_size; ++b)
+                {
+                    auto seqlen = static_cast<int64_t>(seqlens_k[b]);
+                    if(seqlen < 0)
+                        MIGRAPHX_THROW("PAGED_CONCAT_PAST_PRESENT: invalid sequence length");
+                    std::size_t total = seqlen + 1;
+                    if(total < seq_len or (total + block_size - 1) / block_size > max_blocks)
+                        MIGRAPHX_THROW("PAGED_CONCAT_PAST_PRESENT: invalid sequence length");
+                    past_lens[b] = total - seq_len;
+                    for(std::size_t i = 0; i < (total + block_size - 1) / block_size; ++i)
+                    {
+                        auto block = static_cast<int64_t>(block_table[b * max_blocks + i]);
+                        if(block < 0 or block >= static_cast<int64_t>(num_blocks))
+                            MIGRAPHX_THROW("PAGED_CONCAT_PAST_PRESENT: block index out of range");
+                        blocks[b * max_blocks + i] = block;
+                    }
+                }
+            });
+        });
+        visit_all(args[0], args[1])([&](auto cache, auto present) {
+            par_for(batch_size * kv_heads * seq_len, [&](auto i) {
+                std::size_t s     = i % seq_len;
+                std::size_t h     = (i / seq_len) % kv_heads;
+                std::size_t b     = i / (seq_len * kv_heads);
+                std::size_t pos   = past_lens[b] + s;
+                std::size_t block = blocks[b * max_blocks + pos / block_size];
+                std::size_t slot  = (block * kv_heads + h) * block_size + pos % block_size;
+                auto src          = present.begin() + i * head_size;
+                auto dst          = cache.begin() + slot * head_size;
+                std::copy(src, src + head_size, dst);
+            });
+        });
+        return args[0];
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>&) const { return 0; }
+};
+
+} // namespace op
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
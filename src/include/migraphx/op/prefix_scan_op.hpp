@@ -39,6 +39,9 @@
 #include <migraphx/config.hpp>
 #include <migraphx/value.hpp>
 #include <migraphx/op/normalize_attribute.hpp>
+#include <algorithm>
+#include <functional>
+#include <numeric>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -89,6 +92,89 @@ struct prefix_scan_op : op_name<Derived>
         }
     }
 
+    // Scan a standard tensor seen as [outer][n][inner], where n is the length of
+    // the axis. The inner elements are independent slices that are scanned
+    // together, one row of the axis at a time, so the innermost loop is contiguous.
+    // When the axis is innermost and there are fewer rows than blocks in a row,
+    // each row is scanned in blocks in parallel and the block totals are then
+    // propagated, which requires op to be associative.
+    template <class T, class Op>
+    void scan_standard(T* data, const std::vector<std::size_t>& lens, Op op) const
+    {
+        const std::size_t block_size = 4096;
+        std::size_t n                = lens[axis];
+        std::size_t outer            = std::accumulate(
+            lens.begin(), lens.begin() + axis, std::size_t{1}, std::multiplies<>{});
+        std::size_t inner = std::accumulate(
+            lens.begin() + axis + 1, lens.end(), std::size_t{1}, std::multiplies<>{});
+        if(n == 0 or outer == 0 or inner == 0)
+            return;
+        // Pointer to the k-th row of the axis in scan order
+        auto row = [&](std::size_t o, std::size_t k) {
+            return data + (o * n + (reverse ? n - 1 - k : k)) * inner;
+        };
+        // Scan the rows [first, last) of the columns [col, col + ncols)
+        auto scan_rows = [&](std::size_t o,
+                             std::size_t first,
+                             std::size_t last,
+                             std::size_t col,
+                             std::size_t ncols) {
+            for(std::size_t k = first + 1; k < last; k++)
+            {
+                const T* prev = row(o, k - 1) + col;
+                T* x          = row(o, k) + col;
+                for(std::size_t j = 0; j < ncols; j++)
+                    x[j] = op(prev[j], x[j]);
+            }
+        };
+        if(exclusive)
+        {
+            par_for(outer, [&](auto o) {
+                for(std::size_t k = n - 1; k > 0; k--)
+                    std::copy(row(o, k - 1), row(o, k - 1) + inner, row(o, k));
+                std::fill(row(o, 0), row(o, 0) + inner, T(0));
+            });
+        }
+        std::size_t nblocks = (n + block_size - 1) / block_size;
+        if(inner == 1 and nblocks > 1 and outer < nblocks)
+        {
+            par_for(outer * nblocks, [&](auto i) {
+                auto o     = i / nblocks;
+                auto first = (i % nblocks) * block_size;
+                scan_rows(o, first, std::min(first + block_size, n), 0, 1);
+            });
+            // The last element of each block becomes the carry of the next ones
+            std::vector<T> carry(outer * nblocks);
+            for(std::size_t o = 0; o < outer; o++)
+            {
+                for(std::size_t b = 1; b < nblocks; b++)
+                {
+                    T last = *row(o, b * block_size - 1);
+                    carry[o * nblocks + b] =
+                        b == 1 ? last : T(op(carry[o * nblocks + b - 1], last));
+                }
+            }
+            par_for(outer * nblocks, [&](auto i) {
+                auto b = i % nblocks;
+                if(b == 0)
+                    return;
+                auto o     = i / nblocks;
+                auto first = b * block_size;
+                for(std::size_t k = first; k < std::min(first + block_size, n); k++)
+                    *row(o, k) = op(carry[i], *row(o, k));
+            });
+        }
+        else
+        {
+            std::size_t col_block = std::min<std::size_t>(inner, 256);
+            std::size_t ncol      = (inner + col_block - 1) / col_block;
+            par_for(outer * ncol, [&](auto i) {
+                auto col = (i % ncol) * col_block;
+                scan_rows(i / ncol, 0, n, col, std::min(col_block, inner - col));
+            });
+        }
+    }
+
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
         shape output_shape(dyn_out.computed_shape);
@@ -106,11 +192,17 @@ struct prefix_scan_op : op_name<Derived>
             });
             s = output_shape;
         }
+        auto& self = static_cast<const Derived&>(*this);
+        if(s.standard())
+        {
+            result.visit(
+                [&](auto output) { this->scan_standard(output.data(), s.lens(), self.op()); });
+            return result;
+        }
         auto slice = shape{s.type(), {s.lens()[axis]}, {s.strides()[axis]}};
         auto lens  = s.lens();
         lens[axis] = 1;
         auto batch = shape{s.type(), lens, s.strides()};
-        auto& self = static_cast<const Derived&>(*this);
         result.visit([&](auto output) {
             using type = decltype(output);
             par_for(batch.elements(), [&](auto i) {
@@ -30,7 +30,8 @@
 #include <migraphx/stringutils.hpp>
 #include <migraphx/streamutils.hpp>
 #include <migraphx/literal.hpp>
-#include <migraphx/shape_for_each.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/ranges.hpp>
 #include <migraphx/config.hpp>
 #include <cmath>
 #include <utility>
@@ -289,17 +290,40 @@ struct resize
         auto nearest_op = get_nearest_op(nearest_mode);
         auto idx_op     = get_original_idx_op(coordinate_transformation_mode);
 
-        // Populate each element in output by selecting "nearest" item in input.
+        if(output_shape.elements() == 0)
+            return result;
+
+        // The nearest input index along an axis only depends on the output index
+        // along that axis, so precompute a table of input offsets for each axis
+        const auto& in_strides = args[0].get_shape().strides();
+        std::vector<std::vector<std::size_t>> offsets(out_lens.size());
+        for(auto ii : range(out_lens.size()))
+        {
+            offsets[ii].resize(out_lens[ii]);
+            for(auto j : range(out_lens[ii]))
+            {
+                auto idx_val   = idx_op(in_lens[ii], out_lens[ii], j, vec_scale[ii]);
+                offsets[ii][j] = nearest_op(in_lens[ii], idx_val) * in_strides[ii];
+            }
+        }
+
+        // Populate each element in output by selecting "nearest" item in input,
+        // one innermost row at a time
         visit_all(result, args[0])([&](auto output, auto data) {
-            migraphx::shape out_comp_shape{data.get_shape().type(), out_lens};
-            shape_for_each(out_comp_shape, [&](const auto& out_idx_v, size_t out_idx) {
-                std::vector<size_t> in_idx(out_idx_v.size());
-                for(auto ii = 0; ii < out_idx_v.size(); ++ii)
+            const auto& inner = offsets.back();
+            auto rows         = output_shape.elements() / inner.size();
+            par_for(rows, [&](auto row) {
+                std::size_t base = 0;
+                std::size_t r    = row;
+                for(auto ii = out_lens.size() - 1; ii > 0; --ii)
                 {
-                    auto idx_val = idx_op(in_lens[ii], out_lens[ii], out_idx_v[ii], vec_scale[ii]);
-                    in_idx[ii]   = nearest_op(in_lens[ii], idx_val);
+                    base += offsets[ii - 1][r % out_lens[ii - 1]];
+                    r /= out_lens[ii - 1];
                 }
-                output[out_idx] = data(in_idx.begin(), in_idx.end());
+                auto* out      = output.data() + row * inner.size();
+                const auto* in = data.data() + base;
+                for(auto j : range(inner.size()))
+                    out[j] = in[inner[j]];
             });
         });
         return result;
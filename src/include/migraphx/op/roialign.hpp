@@ -32,7 +32,6 @@
 #include <migraphx/par_for.hpp>
 #include <migraphx/dfor.hpp>
 #include <migraphx/ranges.hpp>
-#include <migraphx/shape_for_each.hpp>
 #include <array>
 #include <cmath>
 #include <numeric>
@@ -106,58 +105,68 @@ struct roialign
         std::array<float, 4> w = {0.0f, 0.0f, 0.0f, 0.0f};
     };
 
-    auto calc_pos_weight(const std::array<std::size_t, 2>& dims,
-                         const shape& comp_s,
-                         const std::array<float, 2>& roi_start,
-                         const std::array<float, 2>& bin_size,
-                         const std::array<std::size_t, 2>& bin_grid_size) const
+    struct axis_weight
     {
-        std::vector<pos_weight> results(bin_grid_size[0] * bin_grid_size[1] * output_height *
-                                        output_width);
-        shape_for_each(comp_s, [&](const auto& idx_v, size_t index) {
-            std::array<std::size_t, 2> p = {idx_v[0], idx_v[1]};
-            std::array<std::size_t, 2> i = {idx_v[2], idx_v[3]};
-
-            std::array<float, 2> xy{};
-            std::array<int64_t, 2> low{};
-            std::array<int64_t, 2> high{};
-            for(auto ii : range(p.size()))
-            {
-                xy[ii] = roi_start[ii] + p[ii] * bin_size[ii] +
-                         (i[ii] + .5f) * bin_size[ii] / bin_grid_size[ii];
-                xy[ii] = (coord_trans_mode == "half_pixel") ? (xy[ii] - 0.5f) : xy[ii];
-                if(xy[ii] < -1.0 or xy[ii] > dims[ii])
-                {
-                    results[index] = pos_weight{};
-                    return;
-                }
+        bool valid       = false;
+        std::size_t low  = 0;
+        std::size_t high = 0;
+        // distance from the low neighbor
+        float l = 0.0f;
+        // distance from the high neighbor
+        float h = 0.0f;
+    };
 
-                xy[ii]   = std::max(xy[ii], 0.0f);
-                low[ii]  = xy[ii];
-                high[ii] = low[ii] + 1;
-                if(low[ii] >= dims[ii] - 1)
+    // The sample coordinates along the height and the width are independent, so
+    // the neighbors and weights are computed once per axis for every output bin
+    // and sample, instead of once per output element
+    std::vector<axis_weight> calc_axis_weight(std::size_t dim,
+                                              std::size_t out_dim,
+                                              float roi_start,
+                                              float bin_size,
+                                              std::size_t bin_grid_size) const
+    {
+        std::vector<axis_weight> results(out_dim * bin_grid_size);
+        for(std::size_t p = 0; p < out_dim; p++)
+        {
+            for(std::size_t i = 0; i < bin_grid_size; i++)
+            {
+                float xy = roi_start + p * bin_size + (i + .5f) * bin_size / bin_grid_size;
+                xy       = (coord_trans_mode == "half_pixel") ? (xy - 0.5f) : xy;
+                if(xy < -1.0 or xy > dim)
+                    continue;
+
+                xy           = std::max(xy, 0.0f);
+                int64_t low  = xy;
+                int64_t high = low + 1;
+                if(low >= dim - 1)
                 {
-                    xy[ii] = high[ii] = low[ii] = dims[ii] - 1;
+                    xy = high = low = dim - 1;
                 }
+                auto& result = results[p * bin_grid_size + i];
+                result.valid = true;
+                result.low   = low;
+                result.high  = high;
+                result.l     = xy - low;
+                result.h     = 1.0f - result.l;
             }
-
-            results[index].pos = {low[0] * dims[1] + low[1],
-                                  low[0] * dims[1] + high[1],
-                                  high[0] * dims[1] + low[1],
-                                  high[0] * dims[1] + high[1]};
-
-            float ly = xy[0] - low[0];
-            float lx = xy[1] - low[1];
-            float hy = 1.0f - ly;
-            float hx = 1.0f - lx;
-
-            // save weights and indeces
-            results[index].w = {hy * hx, hy * lx, ly * hx, ly * lx};
-        });
-
+        }
         return results;
     }
 
+    static pos_weight
+    combine_axis_weight(const axis_weight& y, const axis_weight& x, std::size_t width)
+    {
+        if(not y.valid or not x.valid)
+            return {};
+        pos_weight result;
+        result.pos = {y.low * width + x.low,
+                      y.low * width + x.high,
+                      y.high * width + x.low,
+                      y.high * width + x.high};
+        result.w   = {y.h * x.h, y.h * x.l, y.l * x.h, y.l * x.l};
+        return result;
+    }
+
     struct max_pool
     {
         double init() { return std::numeric_limits<double>::lowest(); }
@@ -177,28 +186,19 @@ struct roialign
     };
 
     template <class T, class Op>
-    std::tuple<double, int64_t> calc_pooling(const T& data,
-                                             const std::array<std::size_t, 2>& bin_grid_size,
-                                             const std::vector<pos_weight>& pos_weights,
-                                             int64_t index,
-                                             Op op) const
+    double calc_pooling(const T& data, const std::vector<pos_weight>& pos_weights, Op op) const
     {
-        double output_val   = op.init();
-        const int64_t count = bin_grid_size[0] * bin_grid_size[1];
-        dfor(bin_grid_size[0], bin_grid_size[1])([&](auto, auto) {
-            const auto& pc = pos_weights[index];
+        double output_val = op.init();
+        for(const auto& pc : pos_weights)
+        {
             std::array<double, 4> wv;
             std::transform(
                 pc.w.begin(), pc.w.end(), pc.pos.begin(), wv.begin(), [&](auto w, auto pos) {
                     return *(data + pos) * w;
                 });
             output_val = std::accumulate(wv.begin(), wv.end(), output_val, op);
-            index += 1;
-        });
-
-        output_val = op.final(output_val, count);
-
-        return {output_val, index};
+        }
+        return op.final(output_val, pos_weights.size());
     }
 
     argument compute(const shape& output_shape, std::vector<argument> args) const
@@ -246,38 +246,40 @@ struct roialign
 
                 // we want to precalculate indices and weights shared by all channels,
                 // this is the key point of optimization
-                std::vector<std::size_t> comp_lens = {
-                    out_dims[0], out_dims[1], bin_grid_size[0], bin_grid_size[1]};
-                shape comp_s{shape::float_type, comp_lens};
-                auto pre_calc =
-                    this->calc_pos_weight(in_dims, comp_s, roi_starts, bin_size, bin_grid_size);
-
-                std::vector<std::size_t> comp_lens1 = {channels, out_dims[0], out_dims[1]};
-                shape comp_s1{migraphx::shape::float_type, comp_lens1};
-                std::vector<int64_t> vec_index(channels, 0);
-                shape_for_each(comp_s1, [&](const auto& idx) {
-                    auto c  = idx[0];
-                    auto ph = idx[1];
-                    auto pw = idx[2];
+                std::array<std::vector<axis_weight>, 2> axis_weights;
+                for(auto ii : range(axis_weights.size()))
+                {
+                    axis_weights[ii] = this->calc_axis_weight(
+                        in_dims[ii], out_dims[ii], roi_starts[ii], bin_size[ii], bin_grid_size[ii]);
+                }
+                std::vector<std::vector<pos_weight>> pre_calc(out_dims[0] * out_dims[1]);
+                for(auto ph : range(out_dims[0]))
+                {
+                    for(auto pw : range(out_dims[1]))
+                    {
+                        auto& bin = pre_calc[ph * out_dims[1] + pw];
+                        dfor(bin_grid_size[0], bin_grid_size[1])([&](auto iy, auto ix) {
+                            bin.push_back(combine_axis_weight(
+                                axis_weights[0][ph * bin_grid_size[0] + iy],
+                                axis_weights[1][pw * bin_grid_size[1] + ix],
+                                in_dims[1]));
+                        });
+                    }
+                }
 
+                auto* out = output.data() + n * channels * pre_calc.size();
+                for(auto c : range(channels))
+                {
                     const auto offset_bottom_data =
                         bottom_data + static_cast<int64_t>((roi_batch_ind * channels + c) *
                                                            in_dims[0] * in_dims[1]);
-                    double output_val;
-                    std::tie(output_val, vec_index[c]) =
-                        (mode == migraphx::op::pooling_mode::average)
-                            ? this->calc_pooling(offset_bottom_data,
-                                                 bin_grid_size,
-                                                 pre_calc,
-                                                 vec_index[c],
-                                                 avg_pool{})
-                            : this->calc_pooling(offset_bottom_data,
-                                                 bin_grid_size,
-                                                 pre_calc,
-                                                 vec_index[c],
-                                                 max_pool{});
-                    output(n, c, ph, pw) = output_val;
-                });
+                    for(const auto& bin : pre_calc)
+                    {
+                        *out++ = (mode == migraphx::op::pooling_mode::average)
+                                     ? this->calc_pooling(offset_bottom_data, bin, avg_pool{})
+                                     : this->calc_pooling(offset_bottom_data, bin, max_pool{});
+                    }
+                }
             });
         });
 
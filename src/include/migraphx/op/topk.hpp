@@ -25,6 +25,10 @@
 #define MIGRAPHX_GUARD_OPERATORS_GATHER_HPP
 
 #include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <utility>
 #include <migraphx/check_shapes.hpp>
 #include <migraphx/argument.hpp>
 #include <migraphx/config.hpp>
@@ -63,6 +67,9 @@ struct topk
         check_shapes{inputs, *this}.has(1).standard();
         auto lens = inputs.at(0).lens();
         auto type = inputs.at(0).type();
+        if(k <= 0 or k > static_cast<int64_t>(lens[axis]))
+            MIGRAPHX_THROW("TOPK: k must be in [1, " + std::to_string(lens[axis]) + "], got " +
+                           std::to_string(k));
 
         lens[axis] = k;
 
@@ -72,85 +79,50 @@ struct topk
         return shape({s_val, s_ind});
     }
 
-    template <class T, class Compare>
-    struct heap_vector
-    {
-        std::vector<T> data;
-        Compare compare;
-
-        heap_vector(const std::vector<T>& val, Compare comp) : data(val), compare(std::move(comp))
-        {
-            std::make_heap(data.begin(), data.end(), compare);
-        }
-
-        void try_push(T val)
-        {
-            if(not compare(val, data.front()))
-                return;
-
-            std::pop_heap(data.begin(), data.end(), compare);
-            data.back() = val;
-            std::push_heap(data.begin(), data.end(), compare);
-        }
-
-        std::vector<T> sort()
-        {
-            auto sorted_data = data;
-            std::sort_heap(sorted_data.begin(), sorted_data.end(), compare);
-            return sorted_data;
-        }
-    };
-
-    template <class T, class Compare>
-    heap_vector<T, Compare> make_heap(std::vector<T> val, Compare compare) const
-    {
-        return {std::move(val), std::move(compare)};
-    }
-
     argument compute(const shape& output_shape, std::vector<argument> args) const
     {
         auto vec_ss = output_shape.sub_shapes();
         argument res_val{vec_ss.front()};
         argument res_ind{vec_ss.back()};
-        auto in_s      = args.front().get_shape();
-        auto out_s     = vec_ss.front();
-        auto comp_lens = in_s.lens();
-        auto axis_dim  = comp_lens[axis];
-
-        // compute shape
-        comp_lens[axis] = 1;
-        shape comp_s{in_s.type(), comp_lens};
+        const auto& lens   = args.front().get_shape().lens();
+        std::size_t n      = lens[axis];
+        std::size_t kk     = k;
+        std::size_t stride = std::accumulate(
+            lens.begin() + axis + 1, lens.end(), std::size_t{1}, std::multiplies<>{});
+        std::size_t slices = args.front().get_shape().elements() / n;
         visit_all(res_val, args.front())([&](auto out_val, auto input) {
-            auto* out_ind = res_ind.cast<int64_t>();
-            par_for(comp_s.elements(), [&](auto i) {
-                auto idx = comp_s.multi(i);
-                std::vector<std::size_t> indices(k);
-                std::iota(indices.begin(), indices.end(), 0);
+            using type = typename decltype(input)::value_type;
 
-                auto comp = [&](auto i1, auto i2) {
-                    auto idx1  = idx;
-                    auto idx2  = idx;
-                    idx1[axis] = i1;
-                    idx2[axis] = i2;
-                    return this->largest
-                               ? std::greater<>{}(input[in_s.index(idx1)], input[in_s.index(idx2)])
-                               : std::less<>{}(input[in_s.index(idx1)], input[in_s.index(idx2)]);
+            auto* out_ind = res_ind.cast<int64_t>();
+            // Each slice along the axis is a strided 1-D view, so copy it
+            // with its indices and select the top k with nth_element. Ties
+            // keep the lower index first and NaN orders above every number.
+            par_for(slices, [&](auto i) {
+                auto in_start  = (i / stride) * n * stride + i % stride;
+                auto out_start = (i / stride) * kk * stride + i % stride;
+                std::vector<std::pair<type, int64_t>> values(n);
+                for(std::size_t j = 0; j < n; j++)
+                    values[j] = std::make_pair(input[in_start + j * stride], int64_t(j));
+                auto compare = [&](const auto& x, const auto& y) {
+                    bool x_nan = std::isnan(static_cast<double>(x.first));
+                    bool y_nan = std::isnan(static_cast<double>(y.first));
+                    if(x_nan != y_nan)
+                        return this->largest ? x_nan : y_nan;
+                    if(not x_nan)
+                    {
+                        if(this->largest ? x.first > y.first : x.first < y.first)
+                            return true;
+                        if(this->largest ? y.first > x.first : y.first < x.first)
+                            return false;
+                    }
+                    return x.second < y.second;
                 };
-
-                auto hp = this->make_heap(indices, comp);
-                for(std::size_t ii = indices.size(); ii < axis_dim; ++ii)
-                {
-                    hp.try_push(ii);
-                }
-                auto sorted_indices = hp.sort();
-                auto out_idx        = idx;
-                auto in_idx         = idx;
-                for(auto j : range(sorted_indices.size()))
+                std::nth_element(values.begin(), values.begin() + kk - 1, values.end(), compare);
+                std::sort(values.begin(), values.begin() + kk, compare);
+                for(std::size_t j = 0; j < kk; j++)
                 {
-                    out_idx[axis]                 = j;
-                    in_idx[axis]                  = sorted_indices[j];
-                    out_val[out_s.index(out_idx)] = input[in_s.index(in_idx)];
-                    out_ind[out_s.index(out_idx)] = sorted_indices[j];
+                    out_val[out_start + j * stride] = values[j].first;
+                    out_ind[out_start + j * stride] = values[j].second;
                 }
             });
         });
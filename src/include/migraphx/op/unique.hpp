@@ -29,11 +29,14 @@
 #include <migraphx/check_shapes.hpp>
 #include <migraphx/config.hpp>
 #include <migraphx/argument.hpp>
+#include <migraphx/dyn_output.hpp>
 #include <migraphx/tune_axis.hpp>
-#include <utility>
-#include <map>
+#include <migraphx/hash.hpp>
+#include <algorithm>
 #include <limits>
+#include <numeric>
 #include <optional>
+#include <utility>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -87,6 +90,53 @@ struct unique
         };
     }
 
+    template <class Iterator>
+    static std::size_t hash_chunk(Iterator start, size_t chunk_sz)
+    {
+        std::size_t h = 0;
+        // Hash as double so that values comparing equal, like 0 and -0, hash the same
+        std::for_each(
+            start, start + chunk_sz, [&](auto x) { hash_combine(h, static_cast<double>(x)); });
+        return h;
+    }
+
+    // Find the unique elements/chunks in the order they first appear with an
+    // open addressing hash table of the unique ids, using linear probing.
+    // Returns y_indices, x_rev_indices and y_count in the unsorted order.
+    template <class T>
+    auto hash_uniq_indices(const T& input_data, size_t chunk_sz) const
+    {
+        std::tuple<std::vector<std::size_t>, std::vector<std::size_t>, std::vector<std::size_t>> rv;
+        auto& [y_indices, x_rev_indices, y_count] = rv;
+
+        const size_t count_x = chunk_sz == 0 ? 0 : input_data.size() / chunk_sz;
+        const size_t empty   = std::numeric_limits<size_t>::max();
+        size_t capacity      = 1;
+        while(capacity < 2 * count_x)
+            capacity *= 2;
+        std::vector<size_t> table(capacity, empty);
+        x_rev_indices.reserve(count_x);
+        for(size_t x_idx = 0; x_idx < count_x; x_idx++)
+        {
+            auto start  = input_data.begin() + x_idx * chunk_sz;
+            size_t slot = hash_chunk(start, chunk_sz) & (capacity - 1);
+            while(table[slot] != empty and
+                  not std::equal(start,
+                                 start + chunk_sz,
+                                 input_data.begin() + y_indices[table[slot]] * chunk_sz))
+                slot = (slot + 1) & (capacity - 1);
+            if(table[slot] == empty)
+            {
+                table[slot] = y_indices.size();
+                y_indices.push_back(x_idx);
+                y_count.push_back(0);
+            }
+            y_count[table[slot]]++;
+            x_rev_indices.push_back(table[slot]);
+        }
+        return rv;
+    }
+
     // CASE SORTED:
     //
     // To process into a sorted unique series of elements/chunks:
@@ -107,42 +157,31 @@ struct unique
     template <class T>
     auto sorted_uniq_indices(const T& input_data, size_t chunk_sz) const
     {
-        struct y_info
-        {
-            size_t y_idx;
-            size_t x_idx;
-            size_t ct = 0;
-        };
-
+        auto rv             = hash_uniq_indices(input_data, chunk_sz);
+        auto& y_indices     = std::get<0>(rv);
+        auto& x_rev_indices = std::get<1>(rv);
+        auto& y_count       = std::get<2>(rv);
+
+        // sort only the unique elements, referring to them by their first index in x
+        std::vector<std::size_t> order(y_indices.size());
+        std::iota(order.begin(), order.end(), 0);
         auto idx_less_fn = make_idx_less_fn(input_data, chunk_sz);
-        std::map<size_t, y_info, decltype(idx_less_fn)> uniq_val_map(idx_less_fn);
-
-        std::tuple<std::vector<std::size_t>, std::vector<std::size_t>, std::vector<std::size_t>> rv;
-        auto& [y_indices, x_rev_indices, y_count] = rv;
-
-        // go through all the elements and find the unique elements..
-        size_t count_x = input_data.size();
-        for(size_t f_idx = 0, x_idx = 0; f_idx < count_x; f_idx += chunk_sz, x_idx++)
-        {
-            y_info entry          = {.y_idx = uniq_val_map.size(), .x_idx = x_idx};
-            auto [itr, added_new] = uniq_val_map.insert({f_idx, entry});
-            itr->second.ct++;
-            x_rev_indices.push_back(itr->second.y_idx);
-        }
+        std::sort(order.begin(), order.end(), [&](auto i, auto j) {
+            return idx_less_fn(y_indices[i] * chunk_sz, y_indices[j] * chunk_sz);
+        });
 
-        std::vector<std::size_t> y2x_indices(uniq_val_map.size());
-        y_indices.resize(uniq_val_map.size());
-        y_count.resize(uniq_val_map.size());
-        size_t idx = 0;
-        // the unique elements are now sorted:
+        std::vector<std::size_t> y2x_indices(order.size());
+        std::vector<std::size_t> sorted_y_indices(order.size());
+        std::vector<std::size_t> sorted_y_count(order.size());
         // post-processing for all the return indices.
-        for(const auto& v : uniq_val_map)
+        for(size_t idx = 0; idx < order.size(); idx++)
         {
-            y2x_indices[v.second.y_idx] = idx;
-            y_indices[idx]              = v.second.x_idx;
-            y_count[idx]                = v.second.ct;
-            idx++;
+            y2x_indices[order[idx]] = idx;
+            sorted_y_indices[idx]   = y_indices[order[idx]];
+            sorted_y_count[idx]     = y_count[order[idx]];
         }
+        y_indices = std::move(sorted_y_indices);
+        y_count   = std::move(sorted_y_count);
         // update x_rev_indices as per the sorted order of y_indices
         for(auto& i : x_rev_indices)
             i = y2x_indices[i];
@@ -169,29 +208,7 @@ struct unique
     template <class T>
     auto unsorted_uniq_indices(const T& input_data, size_t chunk_sz) const
     {
-        auto idx_less_fn = make_idx_less_fn(input_data, chunk_sz);
-        std::map<size_t, size_t, decltype(idx_less_fn)> uniq_val_map(idx_less_fn);
-
-        // rv is used for NVRO below..
-        std::tuple<std::vector<std::size_t>, std::vector<std::size_t>, std::vector<std::size_t>> rv;
-        auto& [y_indices, x_rev_indices, y_count] = rv;
-
-        // go through all the elements and add the unique elements into the map..
-        // inline processing for outputs: y_indices, x_rev_indices, y_count
-        size_t count_x = input_data.size();
-        for(size_t f_idx = 0; f_idx < count_x; f_idx += chunk_sz)
-        {
-            auto [itr, added_new] = uniq_val_map.insert({f_idx, y_indices.size()});
-            if(added_new)
-            {
-                y_count.push_back(0);
-                y_indices.push_back(x_rev_indices.size());
-            }
-            y_count[itr->second]++;
-            x_rev_indices.push_back(itr->second);
-        }
-
-        return rv;
+        return hash_uniq_indices(input_data, chunk_sz);
     }
 
     // Axis. Default: none. Range: [-rank, rank-1]
@@ -34,6 +34,7 @@
 #include <migraphx/reflect.hpp>
 #include <migraphx/dyn_output.hpp>
 #include <migraphx/functional.hpp>
+#include <migraphx/hash.hpp>
 #include <migraphx/streamutils.hpp>
 #include <migraphx/normalize_attributes.hpp>
 #include <migraphx/argument.hpp>
@@ -82,6 +83,9 @@ struct operation
     /// An optional method to return which argument the output will alias. If
     /// there is no aliased output then -1 can be returned.
     std::ptrdiff_t output_alias(const std::vector<shape>& input) const;
+    /// An optional method to hash the operation. When this is not implemented,
+    /// the name and the reflected fields are hashed.
+    std::size_t hash() const;
     /// An optional stream operator to print the operation. When this is not
     /// implemented, it will just print the operation's name.
     friend std::ostream& operator<<(std::ostream& os, const operation& op);
@@ -485,6 +489,58 @@ value to_value_op(const T& x)
     return migraphx::to_value(x);
 }
 
+template <class T>
+auto hash_field(rank<4>, const T& x) -> decltype(x.hash())
+{
+    return x.hash();
+}
+
+template <class T>
+auto hash_field(rank<3>, const T& x) -> decltype(std::hash<T>{}(x))
+{
+    return std::hash<T>{}(x);
+}
+
+template <class T>
+auto hash_field(rank<2>, const T& x) -> std::enable_if_t<is_reflectable<T>{}, std::size_t>;
+
+template <class T>
+auto hash_field(rank<1>, const T& x) -> decltype(x.begin(), x.end(), std::size_t{});
+
+template <class T>
+std::size_t hash_field(rank<0>, const T& x)
+{
+    return migraphx::to_value(x).hash();
+}
+
+template <class T>
+auto hash_field(rank<2>, const T& x) -> std::enable_if_t<is_reflectable<T>{}, std::size_t>
+{
+    std::size_t h = 0;
+    reflect_each(x, [&](const auto& y, const auto&) { hash_combine(h, hash_field(rank<4>{}, y)); });
+    return h;
+}
+
+template <class T>
+auto hash_field(rank<1>, const T& x) -> decltype(x.begin(), x.end(), std::size_t{})
+{
+    std::size_t h = 0;
+    for(const auto& y : x)
+        hash_combine(h, hash_field(rank<4>{}, y));
+    return h;
+}
+
+// Hashes the name and the reflected fields so that operators which compare
+// equal have the same hash
+template <class T>
+std::size_t hash_op(const T& x)
+{
+    std::size_t h = hash_value(x.name());
+    if constexpr(is_reflectable<T>{})
+        hash_combine(h, hash_field(rank<2>{}, x));
+    return h;
+}
+
 template <class T>
 void from_value_op(T& x, const value& v)
 {
@@ -550,6 +606,8 @@ struct MIGRAPHX_EXPORT operation
     void from_value(const value& v);
     // (optional)
     value attributes() const;
+    // (optional)
+    std::size_t hash() const;
     //
     friend std::ostream& operator<<(std::ostream& os, const operation& op);
     //
@@ -847,6 +905,19 @@ struct operation
         return detail::attributes_op(private_detail_te_self);
     }
 
+    template <class T>
+    static auto private_detail_te_default_hash(char, T&& private_detail_te_self)
+        -> decltype(private_detail_te_self.hash())
+    {
+        return private_detail_te_self.hash();
+    }
+
+    template <class T>
+    static std::size_t private_detail_te_default_hash(float, T&& private_detail_te_self)
+    {
+        return detail::hash_op(private_detail_te_self);
+    }
+
     template <class PrivateDetailTypeErasedT>
     struct private_te_unwrap_reference
     {
@@ -926,6 +997,7 @@ struct operation
                                                       std::declval<const value&>()),
                  private_detail_te_default_attributes(char(0),
                                                       std::declval<PrivateDetailTypeErasedT>()),
+                 private_detail_te_default_hash(char(0), std::declval<PrivateDetailTypeErasedT>()),
                  static_cast<void>(void()),
                  static_cast<void>(void()),
                  void());
@@ -1116,6 +1188,12 @@ struct operation
         return (*this).private_detail_te_get_handle().attributes();
     }
 
+    std::size_t hash() const
+    {
+        assert((*this).private_detail_te_handle_mem_var);
+        return (*this).private_detail_te_get_handle().hash();
+    }
+
     friend std::ostream& operator<<(std::ostream& os, const operation& op)
     {
         assert(op.private_detail_te_handle_mem_var);
@@ -1173,6 +1251,7 @@ struct operation
         virtual value to_value() const                                                         = 0;
         virtual void from_value(const value& v)                                                = 0;
         virtual value attributes() const                                                       = 0;
+        virtual std::size_t hash() const                                                       = 0;
         virtual std::ostream& operator_shift_left(std::ostream& os) const                      = 0;
         virtual bool operator==(const operation& y) const                                      = 0;
     };
@@ -1324,6 +1403,12 @@ struct operation
             return private_detail_te_default_attributes(char(0), private_detail_te_value);
         }
 
+        std::size_t hash() const override
+        {
+
+            return private_detail_te_default_hash(char(0), private_detail_te_value);
+        }
+
         std::ostream& operator_shift_left(std::ostream& os) const override
         {
             using migraphx::detail::operation_operators::operator<<;
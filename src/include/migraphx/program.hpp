@@ -38,6 +38,7 @@
 #include <migraphx/env.hpp>
 #include <migraphx/config.hpp>
 #include <migraphx/execution_environment.hpp>
+#include <migraphx/memory_usage.hpp>
 #include <algorithm>
 #include <iostream>
 
@@ -84,6 +85,15 @@ struct MIGRAPHX_EXPORT program
 
     std::vector<argument> eval_with_context(std::vector<context>& ctx, parameter_map params) const;
 
+    /// Evaluate a stream of batches by running each run_on_target segment of
+    /// the main module on its own thread, so that different targets work on
+    /// different batches at the same time. At most queue_size batches wait
+    /// between two stages. Results passed between stages and returned are
+    /// copied into host buffers owned by each batch, so targets must produce
+    /// host visible results (the gpu has to be compiled with offload_copy).
+    std::vector<std::vector<argument>> eval_pipelined(std::vector<parameter_map> batches,
+                                                      std::size_t queue_size = 2) const;
+
     void finish() const;
 
     std::size_t size() const;
@@ -114,6 +124,12 @@ struct MIGRAPHX_EXPORT program
 
     void mark(const parameter_map& params, marker&& m);
 
+    memory_usage get_memory_usage() const;
+
+    /// Print the memory used by each module and the n largest results alive
+    /// at the peak of each module
+    void memory_report(std::ostream& os, std::size_t n = 5) const;
+
     value to_value() const;
     void from_value(const value& v);
 
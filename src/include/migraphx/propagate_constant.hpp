@@ -39,6 +39,8 @@ struct module;
 struct MIGRAPHX_EXPORT propagate_constant
 {
     std::unordered_set<std::string> skip_ops = {};
+    /// Skip folds that grow the literals of the module past this many bytes
+    std::size_t memory_budget = 0;
     std::string name() const { return "propagate_constant"; }
     void apply(module& m) const;
 };
@@ -28,6 +28,8 @@
 #include <migraphx/operation.hpp>
 #include <migraphx/auto_register.hpp>
 #include <cstring>
+#include <functional>
+#include <string>
 #include <vector>
 
 namespace migraphx {
@@ -36,6 +38,11 @@ inline namespace MIGRAPHX_INLINE_NS {
 // unregister all ops for specified target, useful when unloading dynamically plugged-in target lib
 MIGRAPHX_EXPORT void unregister_op(const std::string& op_name);
 
+/// Assigns the value to the field named key of an operator, returns false
+/// when the operator has no such field
+using op_field_setter =
+    std::function<bool(operation& op, const std::string& key, const value& v)>;
+
 namespace detail {
 struct op_handler
 {
@@ -45,14 +52,64 @@ struct op_handler
     ~op_handler() { unregister_op(name); }
 };
 
+template <class T>
+auto has_to_value_member(rank<1>, const T& x) -> decltype(x.to_value(), std::true_type{});
+
+template <class T>
+std::false_type has_to_value_member(rank<0>, const T&);
+
+template <class T>
+auto has_from_value_member(rank<1>, T& x)
+    -> decltype(x.from_value(std::declval<const value&>()), std::true_type{});
+
+template <class T>
+std::false_type has_from_value_member(rank<0>, T&);
+
+// Operators that are serialized only through their reflected fields can have
+// their fields assigned directly instead of going through a value
+template <class T>
+using has_reflected_fields =
+    bool_c<is_reflectable<T>{} and
+           not decltype(has_to_value_member(rank<1>{}, std::declval<const T&>())){} and
+           not decltype(has_from_value_member(rank<1>{}, std::declval<T&>())){}>;
+
+template <class T>
+op_field_setter make_op_field_setter()
+{
+    if constexpr(has_reflected_fields<T>{})
+    {
+        return [](operation& op, const std::string& key, const value& v) {
+            auto& x    = any_cast<T>(op);
+            bool found = false;
+            reflect_each(x, [&](auto& y, const std::string& name) {
+                if(found or name != key)
+                    return;
+                y     = from_value<std::decay_t<decltype(y)>>(v);
+                found = true;
+            });
+            return found;
+        };
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
 } // namespace detail
 
 MIGRAPHX_EXPORT void register_op_init();
 
 MIGRAPHX_EXPORT void register_op(const operation& op);
 
+MIGRAPHX_EXPORT void register_op(const operation& op, op_field_setter setter);
+
 MIGRAPHX_EXPORT operation load_op(const std::string& name);
 
+/// Returns the field setter of a registered operator, which is empty when the
+/// operator's fields must be set through from_value
+MIGRAPHX_EXPORT op_field_setter get_op_field_setter(const std::string& name);
+
 MIGRAPHX_EXPORT bool has_op(const std::string& name);
 
 MIGRAPHX_EXPORT std::vector<std::string> get_operators();
@@ -62,7 +119,7 @@ void register_op()
 {
     register_op_init(); // instantiate static op_map;
     static auto op_h = detail::op_handler(T{});
-    register_op(op_h.op);
+    register_op(op_h.op, detail::make_op_field_setter<T>());
 }
 
 struct register_op_action
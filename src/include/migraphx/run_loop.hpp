@@ -34,10 +34,28 @@
 #include <migraphx/ranges.hpp>
 #include <array>
 #include <string>
+#include <unordered_map>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+// Output parameters of a loop body are named "#output_<index>", where the
+// index is the position of the body output they hold. The body writes those
+// outputs straight into the loop buffers instead of returning new arguments.
+inline std::unordered_map<std::string, int> get_loop_output_params(const module& m)
+{
+    const std::string out_prefix = "#output_";
+    std::unordered_map<std::string, int> result;
+    for(const auto& name : m.get_parameter_names())
+    {
+        auto loc = name.find(out_prefix);
+        if(loc == std::string::npos)
+            continue;
+        result[name] = std::stoi(name.substr(loc + out_prefix.size()));
+    }
+    return result;
+}
+
 template <class LoopModel, class T>
 argument run_loop(const LoopModel& model,
                   const std::vector<int64_t>& scan_output_directions,
@@ -75,6 +93,35 @@ argument run_loop(const LoopModel& model,
 
     auto out_param_indices = model.get_output_params(*mod);
 
+    // Bind the parameters of the loop body once. Each entry refers to either
+    // an input argument or an output argument, so only the argument lookup
+    // remains to be done for each iteration.
+    struct param_binding
+    {
+        std::string name;
+        shape s;
+        bool is_output;
+        std::size_t index;
+    };
+    std::vector<param_binding> bindings;
+    bindings.reserve(param_names.size());
+    std::size_t input_index = 0;
+    for(const auto& name : param_names)
+    {
+        const auto& ps = param_name_shapes.at(name);
+        if(ps == shape{})
+            continue;
+
+        // it is an input parameter
+        if(not contains(out_param_indices, name))
+            bindings.push_back({name, ps, false, input_index++});
+        else
+            bindings.push_back({name, ps, true, std::size_t(out_param_indices.at(name))});
+    }
+
+    std::unordered_map<std::string, argument> params;
+    params.reserve(bindings.size());
+
     int64_t iter = 0;
     for(iter = 0; iter < iter_num and cond; ++iter)
     {
@@ -83,38 +130,25 @@ argument run_loop(const LoopModel& model,
         model.copy(ctx, cond, in_args.at(1));
 
         // wrap up the inputs and outputs
-        std::unordered_map<std::string, argument> params;
-        int input_index = 0;
-        for(const auto& name : param_names)
+        for(const auto& b : bindings)
         {
-            auto ps = mod->get_parameter_shape(name);
-            if(ps == shape{})
+            if(not b.is_output)
             {
-                continue;
+                params[b.name] = in_args.at(b.index);
             }
-
-            // it is an input parameter
-            if(not contains(out_param_indices, name))
+            else if(b.index > dep_num)
             {
-                params[name] = in_args.at(input_index++);
+                int64_t dir     = scan_output_directions.empty()
+                                      ? 0
+                                      : scan_output_directions[b.index - dep_num - 1];
+                auto idx        = (1 - dir) * iter + dir * (iter_num - 1 - iter);
+                const auto& arg = out_args.at(b.index);
+                assert((idx + 1) * b.s.bytes() <= arg.get_shape().bytes());
+                params[b.name] = argument(b.s, arg.data() + idx * b.s.bytes());
             }
             else
             {
-                auto output_index = out_param_indices[name];
-                if(output_index > dep_num)
-                {
-                    int64_t dir     = scan_output_directions.empty()
-                                          ? 0
-                                          : scan_output_directions[output_index - dep_num - 1];
-                    auto idx        = (1 - dir) * iter + dir * (iter_num - 1 - iter);
-                    const auto& arg = out_args.at(output_index);
-                    assert((idx + 1) * ps.bytes() <= arg.get_shape().bytes());
-                    params[name] = argument(ps, arg.data() + idx * ps.bytes());
-                }
-                else
-                {
-                    params[name] = out_args.at(output_index);
-                }
+                params[b.name] = out_args.at(b.index);
             }
         }
 
@@ -134,7 +168,28 @@ argument run_loop(const LoopModel& model,
 
     out_args.erase(out_args.begin());
     std::copy(in_args.begin() + 2, in_args.end(), out_args.begin());
-    model.set_zero(ctx, scan_outputs, iter);
+    if(model.trim_scan_outputs)
+    {
+        // Return views of the iterations that were run instead of zero-filling
+        // the remaining iterations of the scan outputs
+        for(auto i : range(scan_outputs.size()))
+        {
+            const auto& scan_out = scan_outputs[i];
+            auto dir             = scan_output_directions.empty() ? 0 : scan_output_directions[i];
+            auto s               = scan_out.get_shape();
+            auto size            = s.bytes() / s.lens().front();
+            auto lens            = s.lens();
+            lens[0]              = iter;
+            auto offset          = dir * (iter_num - iter) * size;
+            assert(offset + iter * size <= s.bytes());
+            out_args.at(dep_num + i) = argument{shape{s.type(), lens},
+                                                [=] { return scan_out.data() + offset; }};
+        }
+    }
+    else
+    {
+        model.set_zero(ctx, scan_outputs, iter);
+    }
 
     return {out_args};
 }
@@ -37,12 +37,14 @@
 #include <type_traits>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
 struct value_base_impl;
+struct value_elements;
 
 template <class To, class = void>
 struct value_converter
@@ -141,6 +143,14 @@ To try_convert_value(const From& x)
     return detail::try_convert_value_impl<To>(rank<3>{}, x);
 }
 
+/**
+ * @brief A dynamically typed value used for serialization and reflection
+ *
+ * Numbers and booleans are stored inline. Strings, binaries, arrays and
+ * objects are stored in a holder that copies share until one of them is
+ * modified. A pointer returned by insert or emplace is only valid until the
+ * value is modified or copied.
+ */
 struct MIGRAPHX_EXPORT value
 {
 // clang-format off
@@ -196,6 +206,7 @@ struct MIGRAPHX_EXPORT value
     value() = default;
 
     value(const value& rhs);
+    value(value&& rhs) noexcept;
     value& operator=(value rhs);
     value(const std::string& pkey, const value& rhs);
 
@@ -341,9 +352,9 @@ struct MIGRAPHX_EXPORT value
         return insert(pos, value(std::forward<Ts>(xs)...));
     }
 
-    void push_back(const value& v) { insert(end(), v); }
+    void push_back(const value& v) { insert(std::as_const(*this).end(), v); }
 
-    void push_front(const value& v) { insert(begin(), v); }
+    void push_front(const value& v) { insert(std::as_const(*this).begin(), v); }
 
     value with_key(const std::string& pkey) const;
     value without_key() const;
@@ -477,6 +488,26 @@ struct MIGRAPHX_EXPORT value
             r.begin(), r.end(), std::back_inserter(v), [&](auto&& e) { return value(e); });
         return v;
     }
+
+    template <class T>
+    void set_data(type_t t, T d);
+    template <class T>
+    const T* if_data(type_t t) const;
+    void set_elements(std::vector<value> v, bool array_on_empty);
+    void assign_data(const value& rhs);
+    const value_elements* get_elements() const;
+    value_elements& mutable_elements(bool leak);
+
+    union scalar_data
+    {
+        std::int64_t int64_value = 0;
+        std::uint64_t uint64_value;
+        double float_value;
+        bool bool_value;
+    };
+
+    type_t vtype = null_type;
+    scalar_data scalar{};
     std::shared_ptr<value_base_impl> x;
     std::string key;
 };
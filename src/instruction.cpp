@@ -27,6 +27,7 @@
 #include <migraphx/module.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/output_iterator.hpp>
+#include <atomic>
 #include <queue>
 
 namespace migraphx {
@@ -59,33 +60,34 @@ instruction::instruction(literal l)
 {
 }
 
-struct replace_shape_order
+static std::atomic<std::size_t>& generation()
 {
-    instruction_ref start;
+    static std::atomic<std::size_t> result{0};
+    return result;
+}
 
-    std::size_t location(instruction_ref x) const { return std::distance(start, x); }
+std::size_t instruction::get_generation() { return generation().load(); }
 
-    bool operator()(instruction_ref x, instruction_ref y) const
-    {
-        return location(x) > location(y);
-    }
+void instruction::next_generation() { generation()++; }
+
+// Orders the instructions by their position in the module
+struct replace_shape_order
+{
+    bool operator()(instruction_ref x, instruction_ref y) const { return x->order > y->order; }
 };
 
 void instruction::replace(const shape& r)
 {
     if(r != result)
     {
+        next_generation();
         result = r;
         if(output.empty())
         {
             return;
         }
-        auto start = std::find_if(output.front()->inputs().begin(),
-                                  output.front()->inputs().end(),
-                                  [&](instruction_ref x) { return this == as_address(x); });
-        assert(as_address(*start) == this);
         std::priority_queue<instruction_ref, std::vector<instruction_ref>, replace_shape_order> q(
-            output.begin(), output.end(), replace_shape_order{*start});
+            output.begin(), output.end());
         while(not q.empty())
         {
             instruction_ref ins = q.top();
@@ -103,6 +105,7 @@ void instruction::replace(const shape& r)
 
 void instruction::replace(operation o)
 {
+    next_generation();
     normalized = false;
     op         = std::move(o);
     recompute_shape();
@@ -112,6 +115,7 @@ void instruction::recompute_shape() { replace(compute_shape(op, arguments, modul
 
 void instruction::clear_arguments()
 {
+    next_generation();
     for(auto&& arg : arguments)
     {
         arg->remove_output(*this);
@@ -211,8 +215,10 @@ bool operator!=(instruction_ref ref, const instruction& i) { return not(i == ref
 
 void instruction::add_output(instruction_ref ins)
 {
-    if(std::find_if(output.begin(), output.end(), equal_to(ins)) == output.end())
-        output.push_back(ins);
+    if(std::find_if(output.begin(), output.end(), equal_to(ins)) != output.end())
+        return;
+    next_generation();
+    output.push_back(ins);
 }
 
 void instruction::backreference(instruction_ref ref)
@@ -317,6 +323,7 @@ void instruction::replace(std::vector<instruction_ref> args, std::vector<module_
 void instruction::replace_argument(instruction_ref old, instruction_ref new_ins)
 {
     assert(std::any_of(arguments.begin(), arguments.end(), equal_to(old)));
+    next_generation();
     std::replace_if(arguments.begin(), arguments.end(), equal_to(old), new_ins);
     old->remove_output(*this);
 }
@@ -324,6 +331,7 @@ void instruction::replace_argument(instruction_ref old, instruction_ref new_ins)
 void instruction::replace_mod_argument(module_ref old, module_ref new_mod)
 {
     assert(std::any_of(module_args.begin(), module_args.end(), [&](auto i) { return i == old; }));
+    next_generation();
     std::replace(module_args.begin(), module_args.end(), old, new_mod);
 }
 
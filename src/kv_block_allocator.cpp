@@ -0,0 +1,129 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/kv_block_allocator.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <numeric>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+kv_block_allocator::kv_block_allocator(std::size_t num_blocks, std::size_t block_size)
+    : m_block_size(block_size), m_num_blocks(num_blocks), free_list(num_blocks)
+{
+    if(block_size == 0)
+        MIGRAPHX_THROW("kv_block_allocator: block size must be greater than zero");
+    // Hand out the lowest block indices first
+    std::iota(free_list.rbegin(), free_list.rend(), 0);
+}
+
+std::size_t kv_block_allocator::num_blocks() const { return m_num_blocks; }
+
+std::size_t kv_block_allocator::block_size() const { return m_block_size; }
+
+std::size_t kv_block_allocator::free_blocks() const { return free_list.size(); }
+
+bool kv_block_allocator::append(std::size_t seq_id, std::size_t n)
+{
+    // A sequence without tokens would have a seqlens_k of -1
+    if(n == 0)
+        MIGRAPHX_THROW("kv_block_allocator: cannot append 0 tokens to sequence " +
+                       std::to_string(seq_id));
+    auto& seq         = sequences[seq_id];
+    auto length       = seq.length + n;
+    auto needed       = (length + m_block_size - 1) / m_block_size;
+    auto extra_blocks = needed - seq.blocks.size();
+    if(extra_blocks > free_list.size())
+    {
+        if(seq.length == 0)
+            sequences.erase(seq_id);
+        return false;
+    }
+    seq.blocks.insert(seq.blocks.end(), free_list.rbegin(), free_list.rbegin() + extra_blocks);
+    free_list.resize(free_list.size() - extra_blocks);
+    seq.length = length;
+    return true;
+}
+
+void kv_block_allocator::release(std::size_t seq_id)
+{
+    auto it = sequences.find(seq_id);
+    if(it == sequences.end())
+        return;
+    free_list.insert(free_list.end(), it->second.blocks.rbegin(), it->second.blocks.rend());
+    sequences.erase(it);
+}
+
+bool kv_block_allocator::contains(std::size_t seq_id) const
+{
+    return sequences.count(seq_id) > 0;
+}
+
+const kv_block_allocator::sequence& kv_block_allocator::get_sequence(std::size_t seq_id) const
+{
+    auto it = sequences.find(seq_id);
+    if(it == sequences.end())
+        MIGRAPHX_THROW("kv_block_allocator: unknown sequence " + std::to_string(seq_id));
+    return it->second;
+}
+
+std::size_t kv_block_allocator::sequence_length(std::size_t seq_id) const
+{
+    return get_sequence(seq_id).length;
+}
+
+const std::vector<std::int32_t>& kv_block_allocator::blocks(std::size_t seq_id) const
+{
+    return get_sequence(seq_id).blocks;
+}
+
+argument kv_block_allocator::make_block_table(const std::vector<std::size_t>& seq_ids,
+                                              std::size_t max_blocks) const
+{
+    argument result{shape{shape::int32_type, {seq_ids.size(), max_blocks}}};
+    auto* data = reinterpret_cast<std::int32_t*>(result.data());
+    std::fill(data, data + seq_ids.size() * max_blocks, -1);
+    for(std::size_t i = 0; i < seq_ids.size(); ++i)
+    {
+        const auto& b = blocks(seq_ids[i]);
+        if(b.size() > max_blocks)
+            MIGRAPHX_THROW("kv_block_allocator: sequence " + std::to_string(seq_ids[i]) +
+                           " uses more than " + std::to_string(max_blocks) + " blocks");
+        std::copy(b.begin(), b.end(), data + i * max_blocks);
+    }
+    return result;
+}
+
+argument kv_block_allocator::make_seqlens_k(const std::vector<std::size_t>& seq_ids) const
+{
+    argument result{shape{shape::int32_type, {seq_ids.size()}}};
+    auto* data = reinterpret_cast<std::int32_t*>(result.data());
+    std::transform(seq_ids.begin(), seq_ids.end(), data, [&](auto seq_id) {
+        return static_cast<std::int32_t>(sequence_length(seq_id)) - 1;
+    });
+    return result;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
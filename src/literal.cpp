@@ -0,0 +1,125 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/literal.hpp>
+#include <migraphx/hash.hpp>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+std::size_t hash_value(const literal& l)
+{
+    auto cached = l.m_hash.data.load();
+    if(cached != 0)
+        return cached;
+    const auto& s = l.get_shape();
+    std::size_t h = hash_value(static_cast<int>(s.type()));
+    for(auto len : s.lens())
+        hash_combine(h, len);
+    for(auto stride : s.strides())
+        hash_combine(h, stride);
+    // Hash as double so that values comparing equal, like 0 and -0, hash the same
+    if(not l.empty())
+        l.visit([&](auto v) {
+            std::for_each(
+                v.begin(), v.end(), [&](auto x) { hash_combine(h, static_cast<double>(x)); });
+        });
+    l.m_hash.data = h;
+    return h;
+}
+
+bool operator==(const literal& x, const literal& y)
+{
+    if(x.get_shape() != y.get_shape())
+        return x.empty() and y.empty();
+    if(x.data() == y.data())
+        return true;
+    if(x.empty() or y.empty())
+        return false;
+    // Literals with different cached hashes cannot have the same data
+    auto xh = x.m_hash.data.load();
+    auto yh = y.m_hash.data.load();
+    if(xh != 0 and yh != 0 and xh != yh)
+        return false;
+    bool result = false;
+    visit_all(x, y)([&](auto xview, auto yview) { result = xview == yview; },
+                    [&](auto&& xs, auto&& ys) {
+                        result = std::equal(xs.begin(), xs.end(), ys.begin(), ys.end());
+                    });
+    return result;
+}
+
+static bool same_data(const shape& s, const char* x, const char* y)
+{
+    return x == y or std::memcmp(x, y, s.bytes()) == 0;
+}
+
+struct interned_literal
+{
+    shape s;
+    std::weak_ptr<char> buffer;
+};
+
+literal intern_literal(const literal& l)
+{
+    if(l.empty())
+        return l;
+    static std::mutex m;
+    static std::unordered_multimap<std::size_t, interned_literal> table;
+    // Number of entries after the last time expired buffers were removed
+    static std::size_t live = 0;
+
+    auto h = hash_value(l);
+    std::lock_guard<std::mutex> lock(m);
+    for(auto [it, last] = table.equal_range(h); it != last; ++it)
+    {
+        auto buffer = it->second.buffer.lock();
+        if(buffer == nullptr or it->second.s != l.get_shape())
+            continue;
+        if(not same_data(l.get_shape(), buffer.get(), l.data()))
+            continue;
+        literal result = l;
+        result.buffer  = buffer;
+        return result;
+    }
+    if(table.size() >= 2 * live)
+    {
+        for(auto it = table.begin(); it != table.end();)
+        {
+            if(it->second.buffer.expired())
+                it = table.erase(it);
+            else
+                ++it;
+        }
+        live = table.size();
+    }
+    table.emplace(h, interned_literal{l.get_shape(), l.buffer});
+    return l;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
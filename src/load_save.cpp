@@ -25,6 +25,7 @@
 #include <migraphx/load_save.hpp>
 #include <migraphx/file_buffer.hpp>
 #include <migraphx/json.hpp>
+#include <migraphx/eliminate_duplicate_literals.hpp>
 #include <migraphx/msgpack.hpp>
 #include <fstream>
 
@@ -54,6 +55,8 @@ program load_buffer(const char* buffer, std::size_t size, const file_options& op
     {
         MIGRAPHX_THROW("Unknown format: " + options.format);
     }
+    if(options.intern_literals)
+        eliminate_duplicate_literals{true}.apply(p);
     return p;
 }
 
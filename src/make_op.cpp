@@ -33,6 +33,17 @@ template <class F>
 operation make_op_generic(const std::string& name, F for_each)
 {
     auto op = load_op(name);
+    // Assign the fields directly when the operator is serialized by reflection
+    auto setter = get_op_field_setter(name);
+    if(setter)
+    {
+        for_each([&](const auto& key, const auto& x) {
+            if(not setter(op, key, x))
+                // NOLINTNEXTLINE(performance-inefficient-string-concatenation)
+                MIGRAPHX_THROW("No key '" + key + "' in " + name);
+        });
+        return op;
+    }
     // Merge values
     value w = op.to_value();
     for_each([&](const auto& key, const auto& x) {
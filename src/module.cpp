@@ -25,6 +25,7 @@
 #include <migraphx/algorithm.hpp>
 #include <migraphx/module.hpp>
 #include <migraphx/bit_signal.hpp>
+#include <migraphx/dom_info.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/target.hpp>
@@ -43,6 +44,8 @@
 #include <sstream>
 #include <algorithm>
 #include <array>
+#include <limits>
+#include <optional>
 #include <set>
 #include <utility>
 #include <unordered_set>
@@ -52,15 +55,118 @@ inline namespace MIGRAPHX_INLINE_NS {
 
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_FINALIZE)
 
+// An analysis of the module that is computed on first use and kept until an
+// instruction or a module is changed
+template <class T>
+struct cached_analysis
+{
+    cached_analysis() = default;
+    // A copy of a module computes its own analyses
+    cached_analysis(const cached_analysis&) {}
+    cached_analysis& operator=(const cached_analysis&)
+    {
+        value.reset();
+        return *this;
+    }
+
+    template <class F>
+    const T& get(F compute)
+    {
+        auto current = instruction::get_generation();
+        if(not value.has_value() or generation != current)
+        {
+            value      = compute();
+            generation = current;
+        }
+        return *value;
+    }
+
+    std::optional<T> value;
+    std::size_t generation = 0;
+};
+
 struct module_impl
 {
     // A list is used to keep references to an instruction stable
     std::list<instruction> instructions;
     std::unordered_set<instruction*> instruction_set;
     std::string name;
-    uint32_t nparams = 0;
-    bool bypass      = false;
+    uint32_t nparams   = 0;
+    bool bypass        = false;
+    bool indices_valid = false;
     bit_signal<64> changed{};
+    cached_analysis<dominator_info> dominators;
+    cached_analysis<ins_dep_map> implicit_deps;
+
+    void notify()
+    {
+        changed.notify();
+        instruction::next_generation();
+    }
+
+    // Spacing between the order labels of instructions added at the end,
+    // which leaves room for many insertions before labels need to be moved
+    static constexpr std::size_t order_gap = std::size_t{1} << 32u;
+
+    void relabel()
+    {
+        std::size_t order = 0;
+        for(auto& ins : instructions)
+        {
+            order += order_gap;
+            ins.order = order;
+        }
+    }
+
+    // Give the instruction a label between the labels of its neighbours. When
+    // there is no room, the following instructions are spread out over the
+    // smallest range that leaves enough room between each of them.
+    void update_order(instruction_ref ins)
+    {
+        indices_valid = false;
+        auto prev     = ins == instructions.begin() ? 0 : std::prev(ins)->order;
+        std::size_t n = 1;
+        auto last     = std::next(ins);
+        for(; last != instructions.end(); ++last, ++n)
+        {
+            auto step = (last->order - prev) / (n + 1);
+            if(step < n)
+                continue;
+            for(auto it = ins; it != last; ++it)
+            {
+                prev += step;
+                it->order = prev;
+            }
+            return;
+        }
+        if(prev > std::numeric_limits<std::size_t>::max() - n * order_gap)
+        {
+            relabel();
+            return;
+        }
+        for(auto it = ins; it != last; ++it)
+        {
+            prev += order_gap;
+            it->order = prev;
+        }
+    }
+
+    void renumber()
+    {
+        std::size_t index = 0;
+        for(auto& ins : instructions)
+            ins.index = index++;
+        indices_valid = true;
+    }
+
+    std::size_t get_index(instruction_ref ins)
+    {
+        if(not indices_valid)
+            renumber();
+        return ins->index;
+    }
+
+    static bool precedes(instruction_ref x, instruction_ref y) { return x->order < y->order; }
 
     bool contains(instruction_ref ins) const
     {
@@ -72,24 +178,26 @@ struct module_impl
     template <class... Ts>
     instruction_ref emplace(instruction_ref pos, Ts&&... xs)
     {
-        changed.notify();
+        notify();
         // cppcheck-suppress redundantInitialization
         auto r = instructions.emplace(pos, std::forward<Ts>(xs)...);
         instruction_set.insert(std::addressof(*r));
+        update_order(r);
         return r;
     }
     instruction_ref insert(instruction_ref pos, const instruction& ins)
     {
-        changed.notify();
+        notify();
         return emplace(pos, ins);
     }
 
     void clear()
     {
-        changed.notify();
+        notify();
         instructions.clear();
         instruction_set.clear();
-        nparams = 0;
+        indices_valid = false;
+        nparams       = 0;
     }
 
     void push_front(const instruction& ins) { insert(instructions.begin(), ins); }
@@ -110,15 +218,17 @@ struct module_impl
 
     instruction_ref erase(instruction_ref pos)
     {
-        changed.notify();
+        notify();
         instruction_set.erase(std::addressof(*pos));
+        indices_valid = false;
         return instructions.erase(pos);
     }
 
     instruction_ref erase(instruction_ref start, instruction_ref last)
     {
-        changed.notify();
+        notify();
         std::for_each(start, last, [&](auto& ins) { instruction_set.erase(std::addressof(ins)); });
+        indices_valid = false;
         return instructions.erase(start, last);
     }
 };
@@ -327,7 +437,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
                                             const operation& op,
                                             std::vector<instruction_ref> args) MIGRAPHX_TIDY_CONST
 {
-    impl->changed.notify();
+    impl->notify();
     assert(has_instruction(ins));
     assert(not starts_with(op.name(), "@"));
 
@@ -342,7 +452,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
                                             std::vector<instruction_ref> args,
                                             std::vector<module_ref> module_args) MIGRAPHX_TIDY_CONST
 {
-    impl->changed.notify();
+    impl->notify();
     assert(has_instruction(ins));
     assert(not starts_with(op.name(), "@"));
     auto out_shape = compute_shape(op, args, module_args);
@@ -353,7 +463,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
 
 instruction_ref module::replace_instruction(instruction_ref ins, instruction_ref rep)
 {
-    impl->changed.notify();
+    impl->notify();
     assert(has_instruction(ins));
     assert(ins != rep);
 
@@ -412,10 +522,11 @@ instruction_ref module::remove_instructions(instruction_ref first, instruction_r
 
 instruction_ref module::move_instruction(instruction_ref src, instruction_ref dst)
 {
-    impl->changed.notify();
+    impl->notify();
     assert(has_instruction(src));
     assert(has_instruction(dst) or is_end(dst, this->end()));
     impl->instructions.splice(dst, impl->instructions, src);
+    impl->update_order(src);
     return src;
 }
 
@@ -423,7 +534,7 @@ instruction_ref module::move_instructions(instruction_ref src, instruction_ref d
 {
     for(auto ins : src->inputs())
     {
-        if(not contains(this->impl->instructions, ins))
+        if(not impl->contains(ins))
             continue;
         this->move_instructions(ins, dst);
     }
@@ -539,7 +650,7 @@ instruction_ref module::insert_parameter(instruction_ref ins, std::string name,
 
 instruction_ref module::replace_return(std::vector<instruction_ref> args)
 {
-    impl->changed.notify();
+    impl->notify();
     auto last = std::prev(this->end());
     // If there is no return then add a return
     if(last->name() != "@return")
@@ -622,7 +733,7 @@ std::vector<instruction_ref> module::get_parameters() const
 
 void module::rename_parameter(instruction_ref ins, const std::string& name)
 {
-    impl->changed.notify();
+    impl->notify();
     assert(ins->name() == "@param");
     auto op      = any_cast<builtin::param>(ins->get_operator());
     op.parameter = name;
@@ -652,6 +763,19 @@ std::size_t module::size() const { return impl->instructions.size(); }
 instruction_ref module::begin() const { return impl->instructions.begin(); }
 instruction_ref module::end() const { return impl->instructions.end(); }
 
+std::size_t module::get_index(instruction_ref ins) const
+{
+    assert(has_instruction(ins));
+    return impl->get_index(ins);
+}
+
+bool module::precedes(instruction_ref x, instruction_ref y) const
+{
+    assert(has_instruction(x));
+    assert(has_instruction(y));
+    return module_impl::precedes(x, y);
+}
+
 std::vector<shape> module::get_output_shapes() const
 {
     if(impl->instructions.empty())
@@ -1440,7 +1564,7 @@ std::vector<module_ref> module::get_sub_modules(bool shallow) const
 
 module& module::sort()
 {
-    auto implicit_deps = calc_implicit_deps();
+    const auto& implicit_deps = get_implicit_deps();
     fix([&](auto self, auto ins) {
         this->move_instruction(ins, this->begin());
         auto ins_inputs = ins->inputs();
@@ -1452,7 +1576,7 @@ module& module::sort()
         }
         for(auto child : ins_inputs)
         {
-            if(not contains(this->impl->instructions, child))
+            if(not impl->contains(child))
             {
                 continue;
             }
@@ -1489,6 +1613,16 @@ void module::calc_implicit_deps(const module& smod,
     }
 }
 
+const dominator_info& module::get_dominator_info() const
+{
+    return impl->dominators.get([&] { return compute_dominator(*this); });
+}
+
+const ins_dep_map& module::get_implicit_deps() const
+{
+    return impl->implicit_deps.get([&] { return calc_implicit_deps(); });
+}
+
 ins_dep_map module::calc_implicit_deps() const
 {
     ins_dep_map mod_implicit_deps;
@@ -40,8 +40,17 @@
 #include <migraphx/make_op.hpp>
 #include <migraphx/marker.hpp>
 #include <migraphx/supported_segments.hpp>
-
+#include <migraphx/simple_par_for.hpp>
+#include <migraphx/functional.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <queue>
 #include <sstream>
 #include <fstream>
@@ -51,6 +60,7 @@
 #include <utility>
 #include <unordered_set>
 #include <map>
+#include <limits>
 #include <cassert>
 
 namespace migraphx {
@@ -58,6 +68,8 @@ inline namespace MIGRAPHX_INLINE_NS {
 
 using milliseconds = std::chrono::duration<double, std::milli>;
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_TARGET_ASSIGNMENTS)
+
 struct mark_instruction_target
 {
     std::size_t target_id = 0;
@@ -181,42 +193,214 @@ instruction_ref program::validate() const
 target_assignments program::get_target_assignments(const std::vector<target>& targets,
                                                    assignment_options options)
 {
-    const auto m = options.metric;
+    const auto* mod        = get_main_module();
+    const std::size_t none = targets.size();
+
+    // Estimated cost of each instruction on the targets that support it, the
+    // metric of a segment is spread evenly over its instructions
+    std::vector<supported_segments> segments(targets.size());
+    std::vector<std::unordered_map<instruction_ref, float>> op_costs(targets.size());
+    std::unordered_map<instruction_ref, std::vector<std::pair<std::size_t, std::size_t>>>
+        ins_segments;
+    for(auto i : range(targets.size()))
+    {
+        segments[i] = targets[i].find_supported(mod, options.metric);
+        for(auto j : range(segments[i].size()))
+        {
+            const auto& segment = segments[i][j];
+            if(segment.instructions.empty())
+                continue;
+            float cost = segment.metric / segment.instructions.size();
+            for(auto ins : segment.instructions)
+            {
+                op_costs[i].emplace(ins, cost);
+                ins_segments[ins].emplace_back(i, j);
+            }
+        }
+    }
 
-    target_assignments p;
+    std::unordered_map<instruction_ref, std::size_t> assigned;
+    // Segments are assigned as units, so the instructions of a unit stay together
+    std::unordered_map<instruction_ref, std::size_t> unit;
+    auto get_target = [&](instruction_ref ins) {
+        auto it = assigned.find(ins);
+        return it == assigned.end() ? none : it->second;
+    };
+    auto bytes_cost = [&](instruction_ref ins) {
+        return options.transfer_cost_per_byte * ins->get_shape().bytes();
+    };
+    // Cost of copying the inputs computed on other targets, parameters and
+    // literals are copied to whichever target uses them
+    auto transfer_cost = [&](instruction_ref ins, std::size_t t) {
+        float cost = 0;
+        for(auto input : ins->inputs())
+        {
+            auto it = get_target(input);
+            if(it == none or it == t or starts_with(input->name(), "@"))
+                continue;
+            cost += bytes_cost(input);
+        }
+        return cost;
+    };
 
-    const auto* mod = get_main_module();
-    std::vector<std::pair<target, supported_segments>> target_subgraphs;
-    target_subgraphs.reserve(targets.size());
-    std::transform(targets.begin(),
-                   targets.end(),
-                   std::back_inserter(target_subgraphs),
-                   [&](const auto& t) { return std::make_pair(t, t.find_supported(mod, m)); });
+    // Place the unassigned instructions of the segment with the lowest
+    // estimated cost per instruction, including copying its inputs. Segments
+    // that are still whole are preferred over the rest of a split segment.
+    // Ties go to the first target.
+    for(auto ins : iterator_for(*mod))
+    {
+        if(contains(assigned, ins) or not contains(ins_segments, ins))
+            continue;
+        std::size_t best = none;
+        std::vector<instruction_ref> best_members;
+        bool best_whole = false;
+        float best_cost = std::numeric_limits<float>::max();
+        for(auto [t, j] : ins_segments.at(ins))
+        {
+            const auto& instructions = segments[t][j].instructions;
+            std::vector<instruction_ref> members;
+            std::copy_if(instructions.begin(),
+                         instructions.end(),
+                         std::back_inserter(members),
+                         [&](auto x) { return not contains(assigned, x); });
+            bool whole = members.size() == instructions.size();
+            float cost = 0;
+            for(auto x : members)
+                cost += op_costs[t].at(x) + transfer_cost(x, t);
+            cost /= members.size();
+            if(best_whole and not whole)
+                continue;
+            if(whole == best_whole and cost >= best_cost)
+                continue;
+            best         = t;
+            best_members = std::move(members);
+            best_whole   = whole;
+            best_cost    = cost;
+        }
+        auto unit_id = unit.size();
+        for(auto x : best_members)
+        {
+            assigned[x] = best;
+            unit[x]     = unit_id;
+        }
+    }
 
-    for(const auto ins : iterator_for(*mod))
+    // Group consecutive instructions on the same target into runs
+    struct assignment_run
     {
-        if(contains(p, ins))
+        std::size_t target_id;
+        std::vector<instruction_ref> instructions;
+    };
+    auto get_runs = [&] {
+        std::vector<assignment_run> runs;
+        for(auto ins : iterator_for(*mod))
         {
-            continue;
+            auto t = get_target(ins);
+            if(t == none or starts_with(ins->name(), "@"))
+                continue;
+            if(runs.empty() or runs.back().target_id != t)
+                runs.push_back({t, {}});
+            runs.back().instructions.push_back(ins);
         }
+        return runs;
+    };
+    // Cost of running a run on a target, including the copies into and out of it
+    auto run_cost = [&](const assignment_run& run, std::size_t t) {
+        std::unordered_set<instruction_ref> members(run.instructions.begin(),
+                                                    run.instructions.end());
+        float cost = 0;
+        for(auto ins : run.instructions)
+        {
+            cost += op_costs[t].at(ins);
+            for(auto input : ins->inputs())
+            {
+                auto it = get_target(input);
+                if(not contains(members, input) and it != none and it != t and
+                   not starts_with(input->name(), "@"))
+                    cost += bytes_cost(input);
+            }
+            for(auto output : ins->outputs())
+            {
+                auto it = get_target(output);
+                if(not contains(members, output) and it != none and it != t)
+                    cost += bytes_cost(ins);
+            }
+        }
+        return cost;
+    };
 
-        for(const auto& [target, subgraph] : target_subgraphs)
+    // Move runs that are too small to the neighbouring target that supports
+    // them when that is cheaper, to avoid ping-ponging between targets. Runs
+    // that only hold part of a segment assigned as a unit are kept.
+    if(options.min_segment_size > 1)
+    {
+        std::unordered_map<std::size_t, std::size_t> unit_sizes;
+        for(const auto& [ins, u] : unit)
         {
-            // can't pass a structured binding into lambda in C++17 so create a variable for it
-            const auto& t = target;
-            for(const auto& segment : subgraph)
+            if(not starts_with(ins->name(), "@"))
+                unit_sizes[u]++;
+        }
+        auto runs = get_runs();
+        for(auto i : range(runs.size()))
+        {
+            auto& run = runs[i];
+            if(run.instructions.size() >= options.min_segment_size)
+                continue;
+            std::unordered_map<std::size_t, std::size_t> run_units;
+            for(auto ins : run.instructions)
+                run_units[unit.at(ins)]++;
+            if(std::any_of(run_units.begin(), run_units.end(), [&](const auto& p) {
+                   return p.second != unit_sizes.at(p.first);
+               }))
+                continue;
+            std::vector<std::size_t> candidates;
+            if(i > 0)
+                candidates.push_back(runs[i - 1].target_id);
+            if(i + 1 < runs.size())
+                candidates.push_back(runs[i + 1].target_id);
+            auto best      = run.target_id;
+            auto best_cost = run_cost(run, run.target_id);
+            for(auto t : candidates)
             {
-                const auto& instructions = segment.instructions;
-                if(not contains(instructions, ins))
-                {
+                if(not std::all_of(run.instructions.begin(), run.instructions.end(), [&](auto ins) {
+                       return contains(op_costs[t], ins);
+                   }))
                     continue;
+                auto cost = run_cost(run, t);
+                if(cost < best_cost)
+                {
+                    best      = t;
+                    best_cost = cost;
                 }
-                std::transform(instructions.begin(),
-                               instructions.end(),
-                               std::inserter(p, p.end()),
-                               [&](auto instr) { return std::make_pair(instr, t.name()); });
             }
+            for(auto ins : run.instructions)
+                assigned[ins] = best;
+            run.target_id = best;
+        }
+    }
+
+    target_assignments p;
+    for(const auto& [ins, t] : assigned)
+        p.insert(p.end(), std::make_pair(ins, targets[t].name()));
+
+    if(enabled(MIGRAPHX_TRACE_TARGET_ASSIGNMENTS{}))
+    {
+        float total = 0;
+        for(const auto& run : get_runs())
+        {
+            float cost        = 0;
+            float copies_cost = 0;
+            for(auto ins : run.instructions)
+            {
+                cost += op_costs[run.target_id].at(ins);
+                copies_cost += transfer_cost(ins, run.target_id);
+            }
+            total += cost + copies_cost;
+            std::cout << targets[run.target_id].name() << ": " << run.instructions.size()
+                      << " instructions, cost " << cost << ", transfer cost " << copies_cost
+                      << std::endl;
         }
+        std::cout << "Estimated total cost: " << total << std::endl;
     }
     return p;
 }
@@ -458,92 +642,134 @@ static bool is_compatible_shape(const shape& actual, const shape& expected)
 }
 #endif
 
+// Results computed while evaluating a module. A submodule only stores the
+// instructions it computes itself and looks up instructions captured from
+// the enclosing modules through the parent chain, so invoking a submodule
+// (ie for each loop iteration) does not copy the results of the parent.
+struct eval_results
+{
+    const eval_results* parent = nullptr;
+    std::unordered_map<instruction_ref, argument> results;
+
+    bool contains(instruction_ref ins) const
+    {
+        if(results.count(ins) > 0)
+            return true;
+        return parent != nullptr and parent->contains(ins);
+    }
+
+    const argument& at(instruction_ref ins) const
+    {
+        auto it = results.find(ins);
+        if(it != results.end())
+            return it->second;
+        assert(parent != nullptr);
+        return parent->at(ins);
+    }
+};
+
+template <class F>
+argument eval_instruction(instruction_ref ins,
+                          std::vector<context>& ctx,
+                          const std::unordered_map<std::string, argument>& params,
+                          const eval_results& local,
+                          std::vector<argument>& values,
+                          F trace);
+
 template <class F>
 std::vector<argument> generic_eval(const module* mod,
                                    std::vector<context>& ctx,
-                                   std::unordered_map<std::string, argument> params,
-                                   std::unordered_map<instruction_ref, argument> results,
+                                   const std::unordered_map<std::string, argument>& params,
+                                   const eval_results* parent,
                                    F trace)
 {
     assert(mod->validate() == mod->end());
-    results.reserve(mod->size() * 2);
+    eval_results local{parent};
+    auto& results = local.results;
+    results.reserve(mod->size());
     std::vector<argument> values;
     values.reserve(16);
     for(auto ins : iterator_for(*mod))
     {
         assert(results.find(ins) == results.end());
-        const auto& name = ins->name();
-        if(name == "@literal")
-        {
-            results.emplace(ins, trace(ins, [&] { return ins->get_literal().get_argument(); }));
-        }
-        else if(name == "@param")
-        {
-            results.emplace(
-                ins, trace(ins, [&] {
-                    auto param_name = any_cast<builtin::param>(ins->get_operator()).parameter;
-                    if(not contains(params, param_name))
-                        MIGRAPHX_THROW("Parameter not found: " + param_name);
-                    auto param = params[param_name];
-                    // TODO: may want to check correct number of dimensions and/or was within bounds
-                    if(not ins->get_shape().any_of_dynamic() and
-                       param.get_shape() != ins->get_shape())
-                    {
-                        MIGRAPHX_THROW("Incorrect shape {" + to_string(param.get_shape()) +
-                                       "} for parameter: " + param_name +
-                                       " should be: " + to_string(ins->get_shape()));
-                    }
-                    return param;
-                }));
-        }
-        else if(name == "@outline")
-        {
-            results.emplace(ins, trace(ins, [&] { return argument{ins->get_shape(), nullptr}; }));
-        }
-        else if(name == "@return")
+        if(ins->name() == "@return")
         {
             std::vector<argument> prog_outputs;
             std::transform(ins->inputs().begin(),
                            ins->inputs().end(),
                            std::back_inserter(prog_outputs),
                            [&](instruction_ref i) {
-                               assert(results.find(i) != results.end());
-                               return results[i];
+                               assert(local.contains(i));
+                               return local.at(i);
                            });
 
             return prog_outputs;
         }
-        else
-        {
-            values.resize(ins->inputs().size());
-            std::transform(
-                ins->inputs().begin(), ins->inputs().end(), values.begin(), [&](instruction_ref i) {
-                    assert(results.find(i) != results.end());
-                    return results[i];
-                });
-            const auto& mod_args = ins->module_inputs();
-            auto module_eval     = [&](module_ref smod,
-                                   const std::unordered_map<std::string, argument>& inputs) {
-                return generic_eval(smod, ctx, inputs, results, trace);
-            };
-
-            results.emplace(
-                ins, trace(ins, [&] {
-                    auto op = ins->normalized_operator();
-                    if(op.is_context_free())
-                        return op.compute(ins->get_shape(), values, mod_args, module_eval);
-                    if(ins->get_target_id() >= ctx.size())
-                        MIGRAPHX_THROW("No context available for " + op.name());
-                    return op.compute(
-                        ctx[ins->get_target_id()], ins->get_shape(), values, mod_args, module_eval);
-                }));
-        }
+        results.emplace(ins, eval_instruction(ins, ctx, params, local, values, trace));
         assert(results.find(ins) != results.end());
         assert(is_compatible_shape(results.at(ins).get_shape(), ins->get_shape()));
     }
     return {results.at(std::prev(mod->end()))};
 }
 
+template <class F>
+argument eval_instruction(instruction_ref ins,
+                          std::vector<context>& ctx,
+                          const std::unordered_map<std::string, argument>& params,
+                          const eval_results& local,
+                          std::vector<argument>& values,
+                          F trace)
+{
+    const auto& name = ins->name();
+    if(name == "@literal")
+    {
+        return trace(ins, [&] { return ins->get_literal().get_argument(); });
+    }
+    if(name == "@param")
+    {
+        return trace(ins, [&] {
+            auto param_name = any_cast<builtin::param>(ins->get_operator()).parameter;
+            auto it         = params.find(param_name);
+            if(it == params.end())
+                MIGRAPHX_THROW("Parameter not found: " + param_name);
+            const auto& param = it->second;
+            // TODO: may want to check correct number of dimensions and/or was within bounds
+            if(not ins->get_shape().any_of_dynamic() and param.get_shape() != ins->get_shape())
+            {
+                MIGRAPHX_THROW("Incorrect shape {" + to_string(param.get_shape()) +
+                               "} for parameter: " + param_name +
+                               " should be: " + to_string(ins->get_shape()));
+            }
+            return param;
+        });
+    }
+    if(name == "@outline")
+    {
+        return trace(ins, [&] { return argument{ins->get_shape(), nullptr}; });
+    }
+    values.resize(ins->inputs().size());
+    std::transform(
+        ins->inputs().begin(), ins->inputs().end(), values.begin(), [&](instruction_ref i) {
+            assert(local.contains(i));
+            return local.at(i);
+        });
+    const auto& mod_args = ins->module_inputs();
+    auto module_eval     = [&](module_ref smod,
+                           const std::unordered_map<std::string, argument>& inputs) {
+        return generic_eval(smod, ctx, inputs, &local, trace);
+    };
+
+    return trace(ins, [&] {
+        auto op = ins->normalized_operator();
+        if(op.is_context_free())
+            return op.compute(ins->get_shape(), values, mod_args, module_eval);
+        if(ins->get_target_id() >= ctx.size())
+            MIGRAPHX_THROW("No context available for " + op.name());
+        return op.compute(
+            ctx[ins->get_target_id()], ins->get_shape(), values, mod_args, module_eval);
+    });
+}
+
 template <class F>
 std::vector<argument> generic_eval(const program& p,
                                    std::vector<context>& ctx,
@@ -551,14 +777,14 @@ std::vector<argument> generic_eval(const program& p,
                                    F trace)
 {
     const module* mm = p.get_main_module();
-    return generic_eval(mm, ctx, params, {}, trace);
+    return generic_eval(mm, ctx, params, nullptr, trace);
 }
 
 std::vector<argument> program::eval_with_context(std::vector<context>& ctx,
                                                  parameter_map params) const
 {
     const module* mm = this->get_main_module();
-    return generic_eval(mm, ctx, std::move(params), {}, [](auto&&, auto f) { return f(); });
+    return generic_eval(mm, ctx, params, nullptr, [](auto&&, auto f) { return f(); });
 }
 
 std::vector<argument> program::eval(parameter_map params, execution_environment exec_env) const
@@ -642,6 +868,274 @@ std::vector<argument> program::eval(parameter_map params, execution_environment
     return ret;
 }
 
+// Blocking queue with a fixed capacity used to hand batches from one stage
+// of the pipeline to the next. Once closed, pushes fail and pops drain the
+// remaining items before failing.
+template <class T>
+struct bounded_queue
+{
+    explicit bounded_queue(std::size_t n) : capacity(std::max<std::size_t>(n, 1)) {}
+
+    bool push(T x)
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return closed or items.size() < capacity; });
+        if(closed)
+            return false;
+        items.push_back(std::move(x));
+        cv.notify_all();
+        return true;
+    }
+
+    bool pop(T& x)
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return closed or not items.empty(); });
+        if(items.empty())
+            return false;
+        x = std::move(items.front());
+        items.pop_front();
+        cv.notify_all();
+        return true;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(m);
+        closed = true;
+        cv.notify_all();
+    }
+
+    private:
+    std::size_t capacity;
+    std::deque<T> items;
+    bool closed = false;
+    std::mutex m;
+    std::condition_variable cv;
+};
+
+struct pipeline_stage
+{
+    std::vector<instruction_ref> instructions;
+    // Targets whose context is used by this stage, sorted so locks are
+    // always acquired in the same order
+    std::vector<std::size_t> target_ids;
+    // Results read by later stages or returned from the program
+    std::vector<instruction_ref> outputs;
+};
+
+struct pipeline_batch
+{
+    std::size_t index = 0;
+    parameter_map params;
+    eval_results values;
+};
+
+// Split the main module so that each stage holds one run_on_target
+// instruction along with the instructions that follow it up to the next
+// run_on_target.
+static std::vector<pipeline_stage> make_pipeline_stages(const module& m)
+{
+    std::vector<pipeline_stage> stages(1);
+    bool has_target = false;
+    for(auto ins : iterator_for(m))
+    {
+        if(ins->name() == "@return")
+            continue;
+        if(ins->name() == "run_on_target")
+        {
+            if(has_target)
+                stages.emplace_back();
+            has_target = true;
+            stages.back().target_ids.push_back(
+                ins->get_operator().to_value()["target_id"].to<std::size_t>());
+        }
+        else if(ins->name().front() != '@' and not ins->get_operator().is_context_free())
+        {
+            stages.back().target_ids.push_back(ins->get_target_id());
+        }
+        stages.back().instructions.push_back(ins);
+    }
+    std::unordered_map<instruction_ref, std::size_t> stage_of;
+    for(std::size_t i = 0; i < stages.size(); i++)
+    {
+        for(auto ins : stages[i].instructions)
+            stage_of[ins] = i;
+    }
+    auto last = std::prev(m.end());
+    for(std::size_t i = 0; i < stages.size(); i++)
+    {
+        auto& stage = stages[i];
+        std::sort(stage.target_ids.begin(), stage.target_ids.end());
+        stage.target_ids.erase(std::unique(stage.target_ids.begin(), stage.target_ids.end()),
+                               stage.target_ids.end());
+        for(auto ins : stage.instructions)
+        {
+            if(ins->name().front() == '@')
+                continue;
+            bool returned = last->name() == "@return" ? contains(last->inputs(), ins) : ins == last;
+            if(returned or std::any_of(ins->outputs().begin(), ins->outputs().end(), [&](auto out) {
+                   return stage_of.count(out) > 0 and stage_of.at(out) > i;
+               }))
+                stage.outputs.push_back(ins);
+        }
+    }
+    return stages;
+}
+
+// Deep copy of a result into host memory owned by the batch
+static argument copy_to_batch(const argument& a)
+{
+    if(a.empty())
+        return a;
+    if(a.get_shape().type() == shape::tuple_type)
+    {
+        auto subs = a.get_sub_objects();
+        std::transform(subs.begin(), subs.end(), subs.begin(), &copy_to_batch);
+        return argument{subs};
+    }
+    return a.copy();
+}
+
+std::vector<std::vector<argument>> program::eval_pipelined(std::vector<parameter_map> batches,
+                                                           std::size_t queue_size) const
+{
+    const module* mm = this->get_main_module();
+    auto stages      = make_pipeline_stages(*mm);
+    std::vector<std::vector<argument>> outputs(batches.size());
+    if(stages.size() < 2 or batches.size() < 2)
+    {
+        std::transform(batches.begin(), batches.end(), outputs.begin(), [&](auto& params) {
+            return this->eval(std::move(params));
+        });
+        return outputs;
+    }
+
+    auto& contexts = this->impl->contexts;
+    auto last      = std::prev(mm->end());
+    std::vector<std::mutex> target_locks(contexts.size());
+    for(const auto& stage : stages)
+    {
+        if(std::any_of(stage.target_ids.begin(), stage.target_ids.end(), [&](auto id) {
+               return id >= contexts.size();
+           }))
+            MIGRAPHX_THROW("EVAL_PIPELINED: No context available for target");
+    }
+
+    // Batches are recycled through the free list once their outputs are
+    // collected, which bounds the number of batches in flight and lets the
+    // result maps keep their storage between batches.
+    queue_size = std::max<std::size_t>(queue_size, 1);
+    std::size_t n_slots = std::min(batches.size(), stages.size() * queue_size);
+    bounded_queue<std::unique_ptr<pipeline_batch>> free_batches{n_slots};
+    for(std::size_t i = 0; i < n_slots; i++)
+        free_batches.push(std::make_unique<pipeline_batch>());
+    std::vector<std::unique_ptr<bounded_queue<std::unique_ptr<pipeline_batch>>>> queues;
+    std::generate_n(std::back_inserter(queues), stages.size(), [&] {
+        return std::make_unique<bounded_queue<std::unique_ptr<pipeline_batch>>>(queue_size);
+    });
+
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex error_lock;
+    auto abort = [&] {
+        {
+            std::lock_guard<std::mutex> lock(error_lock);
+            if(not error)
+                error = std::current_exception();
+        }
+        failed = true;
+        free_batches.close();
+        for(auto& q : queues)
+            q->close();
+    };
+
+    auto run_stage = [&](std::size_t i) {
+        const auto& stage = stages[i];
+        std::vector<argument> values;
+        std::unique_ptr<pipeline_batch> batch;
+        while(queues[i]->pop(batch))
+        {
+            if(failed)
+                continue;
+            try
+            {
+                std::vector<std::unique_lock<std::mutex>> locks;
+                for(auto id : stage.target_ids)
+                    locks.emplace_back(target_locks[id]);
+                auto& results = batch->values.results;
+                for(auto ins : stage.instructions)
+                {
+                    results.emplace(ins,
+                                    eval_instruction(ins,
+                                                     contexts,
+                                                     batch->params,
+                                                     batch->values,
+                                                     values,
+                                                     [](auto&&, auto f) { return f(); }));
+                }
+                // The next stage may run on another target so the results of
+                // this one have to be ready before handing them off
+                for(auto id : stage.target_ids)
+                    contexts[id].finish();
+                // Targets can return results that live in buffers reused by
+                // every evaluation, such as the scratch memory of the cpu
+                // target, which this stage overwrites with the next batch
+                for(auto ins : stage.outputs)
+                    results[ins] = copy_to_batch(results.at(ins));
+            }
+            catch(...)
+            {
+                abort();
+                continue;
+            }
+            if(i + 1 < stages.size())
+            {
+                queues[i + 1]->push(std::move(batch));
+                continue;
+            }
+            auto& output = outputs[batch->index];
+            if(last->name() == "@return")
+            {
+                std::transform(last->inputs().begin(),
+                               last->inputs().end(),
+                               std::back_inserter(output),
+                               [&](instruction_ref ins) { return batch->values.at(ins); });
+            }
+            else
+            {
+                output = {batch->values.at(last)};
+            }
+            batch->values.results.clear();
+            batch->params.clear();
+            free_batches.push(std::move(batch));
+        }
+        if(i + 1 < stages.size())
+            queues[i + 1]->close();
+    };
+
+    {
+        std::vector<joinable_thread> workers;
+        for(std::size_t i = 0; i < stages.size(); i++)
+            workers.emplace_back([&, i] { run_stage(i); });
+        for(std::size_t i = 0; i < batches.size(); i++)
+        {
+            std::unique_ptr<pipeline_batch> batch;
+            if(not free_batches.pop(batch) or failed)
+                break;
+            batch->index  = i;
+            batch->params = std::move(batches[i]);
+            batch->values.results.reserve(mm->size());
+            if(not queues.front()->push(std::move(batch)))
+                break;
+        }
+        queues.front()->close();
+    }
+    if(error)
+        std::rethrow_exception(error);
+    return outputs;
+}
+
 void program::finish() const
 {
     for(const auto& ctx : this->impl->contexts)
@@ -1025,6 +1519,183 @@ void program::perf_report(
        << ", " << std::round(calculate_overhead_percent) << "%" << std::endl;
 }
 
+std::size_t memory_usage::total_bytes() const
+{
+    std::size_t result = literal_bytes;
+    if(not modules.empty())
+        result += modules.front().parameter_bytes + modules.front().output_bytes;
+    for(const auto& mu : modules)
+        result += mu.scratch_bytes + mu.peak_live_bytes;
+    return result;
+}
+
+static std::size_t memory_bytes(const shape& s)
+{
+    if(s.type() == shape::tuple_type)
+    {
+        return transform_accumulate(s.sub_shapes().begin(),
+                                    s.sub_shapes().end(),
+                                    std::size_t{0},
+                                    std::plus<>{},
+                                    [](const shape& ss) { return memory_bytes(ss); });
+    }
+    if(s.dynamic())
+        return shape{s.type(), s.max_lens()}.bytes();
+    return s.bytes();
+}
+
+static bool is_output_parameter(const std::string& name)
+{
+    return name == "output" or contains(name, "#output_");
+}
+
+// Whether the result of the instruction is a buffer of its own, rather than
+// a literal, a parameter, or a view of another result or of the scratch memory
+static bool owns_result(instruction_ref ins)
+{
+    if(ins->name().front() == '@' or ins->name() == "load")
+        return false;
+    return instruction::get_output_alias(ins) == ins;
+}
+
+static module_memory_usage get_module_memory_usage(const module& m,
+                                                   std::unordered_set<const char*>& literals,
+                                                   std::size_t& literal_bytes)
+{
+    module_memory_usage result;
+    result.name = m.name();
+    std::unordered_map<instruction_ref, std::size_t> positions;
+    for(auto ins : iterator_for(m))
+        positions.emplace(ins, positions.size());
+
+    // Results owned by an instruction, grouped by the position of their last use
+    std::vector<std::vector<instruction_ref>> last_uses(positions.size());
+    for(auto ins : iterator_for(m))
+    {
+        auto bytes = memory_bytes(ins->get_shape());
+        if(ins->name() == "@literal")
+        {
+            result.literal_bytes += bytes;
+            if(literals.insert(ins->get_literal().data()).second)
+                literal_bytes += bytes;
+        }
+        else if(ins->name() == "@param")
+        {
+            auto name = any_cast<builtin::param>(ins->get_operator()).parameter;
+            if(name == "scratch")
+                result.scratch_bytes += bytes;
+            else if(is_output_parameter(name))
+                result.output_bytes += bytes;
+            else
+                result.parameter_bytes += bytes;
+        }
+        if(not owns_result(ins))
+            continue;
+        if(ends_with(ins->name(), "allocate"))
+            result.allocation_bytes += bytes;
+        std::size_t last = positions.at(ins);
+        for(auto output : ins->outputs())
+        {
+            auto it = positions.find(output);
+            if(it != positions.end())
+                last = std::max(last, it->second);
+        }
+        last_uses[last].push_back(ins);
+    }
+
+    std::unordered_set<instruction_ref> live;
+    std::size_t live_bytes = 0;
+    for(auto ins : iterator_for(m))
+    {
+        if(owns_result(ins))
+        {
+            live.insert(ins);
+            live_bytes += memory_bytes(ins->get_shape());
+        }
+        if(live_bytes > result.peak_live_bytes)
+        {
+            result.peak_live_bytes = live_bytes;
+            result.peak_live_instructions.assign(live.begin(), live.end());
+        }
+        for(auto dead : last_uses[positions.at(ins)])
+        {
+            live.erase(dead);
+            live_bytes -= memory_bytes(dead->get_shape());
+        }
+    }
+    std::sort(result.peak_live_instructions.begin(),
+              result.peak_live_instructions.end(),
+              by(std::greater<>{}, [](auto ins) { return memory_bytes(ins->get_shape()); }));
+    return result;
+}
+
+memory_usage program::get_memory_usage() const
+{
+    memory_usage result;
+    std::unordered_set<const char*> literals;
+    for(const auto* mod : this->get_modules())
+        result.modules.push_back(get_module_memory_usage(*mod, literals, result.literal_bytes));
+    return result;
+}
+
+static std::string format_bytes(std::size_t bytes)
+{
+    std::stringstream ss;
+    ss << bytes << " bytes";
+    if(bytes >= 1024 * 1024)
+        ss << " (" << std::fixed << std::setprecision(2) << bytes / (1024.0 * 1024.0) << " MiB)";
+    return ss.str();
+}
+
+void program::memory_report(std::ostream& os, std::size_t n) const
+{
+    auto usage = this->get_memory_usage();
+    std::unordered_map<instruction_ref, std::string> ins_out;
+    this->print([&](auto ins, auto ins_names) {
+        std::stringstream ss;
+        instruction::print(ss, ins, ins_names);
+        ins_out[ins] = ss.str();
+    });
+
+    for(const auto& mu : usage.modules)
+    {
+        os << "Module " << mu.name << ":" << std::endl;
+        os << "    Literals: " << format_bytes(mu.literal_bytes) << std::endl;
+        os << "    Parameters: " << format_bytes(mu.parameter_bytes) << std::endl;
+        os << "    Outputs: " << format_bytes(mu.output_bytes) << std::endl;
+        os << "    Scratch: " << format_bytes(mu.scratch_bytes) << std::endl;
+        os << "    Allocations: " << format_bytes(mu.allocation_bytes) << std::endl;
+        os << "    Peak live results: " << format_bytes(mu.peak_live_bytes) << std::endl;
+        auto k = std::min(n, mu.peak_live_instructions.size());
+        for(auto ins : range(mu.peak_live_instructions.begin(),
+                             mu.peak_live_instructions.begin() + k))
+        {
+            os << "        " << format_bytes(memory_bytes(ins->get_shape())) << ": "
+               << ins_out.at(ins) << std::endl;
+        }
+    }
+    os << std::endl;
+    os << "Summary:" << std::endl;
+    os << "Literals: " << format_bytes(usage.literal_bytes) << std::endl;
+    os << "Parameters: " << format_bytes(usage.modules.front().parameter_bytes) << std::endl;
+    os << "Outputs: " << format_bytes(usage.modules.front().output_bytes) << std::endl;
+    os << "Scratch: "
+       << format_bytes(transform_accumulate(usage.modules.begin(),
+                                            usage.modules.end(),
+                                            std::size_t{0},
+                                            std::plus<>{},
+                                            [](const auto& mu) { return mu.scratch_bytes; }))
+       << std::endl;
+    os << "Peak live results: "
+       << format_bytes(transform_accumulate(usage.modules.begin(),
+                                            usage.modules.end(),
+                                            std::size_t{0},
+                                            std::plus<>{},
+                                            [](const auto& mu) { return mu.peak_live_bytes; }))
+       << std::endl;
+    os << "Total: " << format_bytes(usage.total_bytes()) << std::endl;
+}
+
 void program::debug_print() const { std::cout << *this << std::endl; }
 void program::debug_print(instruction_ref ins) const
 {
@@ -28,7 +28,9 @@
 #include <migraphx/functional.hpp>
 #include <migraphx/simple_par_for.hpp>
 #include <migraphx/env.hpp>
+#include <algorithm>
 #include <thread>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace migraphx {
@@ -57,6 +59,69 @@ bool is_const_ins(instruction_ref ins, const std::unordered_set<std::string>& sk
            skip_ops.find(ins->name()) == skip_ops.end();
 }
 
+// Drop the folds that would grow the literals of the module past the budget,
+// keeping the earlier ones in the module. A fold only frees the literals whose
+// users are all removed by the folds that are kept, and each literal is only
+// freed once.
+static void apply_memory_budget(const module& m,
+                                std::vector<instruction_ref>& const_instrs,
+                                std::size_t memory_budget)
+{
+    std::size_t literal_bytes = 0;
+    std::unordered_map<instruction_ref, std::size_t> position;
+    for(auto ins : iterator_for(m))
+    {
+        position[ins] = position.size();
+        if(ins->name() == "@literal")
+            literal_bytes += ins->get_shape().bytes();
+    }
+    // Instructions that are removed once the kept folds are replaced by literals
+    std::unordered_set<instruction_ref> dead;
+    std::unordered_set<instruction_ref> candidates(const_instrs.begin(), const_instrs.end());
+    const_instrs.clear();
+    for(auto ins : iterator_for(m))
+    {
+        if(not contains(candidates, ins))
+            continue;
+        std::vector<instruction_ref> ancestors;
+        std::unordered_set<instruction_ref> visited;
+        fix([&](auto self, auto i) {
+            for(auto input : i->inputs())
+            {
+                if(contains(dead, input) or not visited.insert(input).second)
+                    continue;
+                ancestors.push_back(input);
+                self(input);
+            }
+        })(ins);
+        // Visit users before their inputs so an input is dead once all its users are
+        std::sort(ancestors.begin(), ancestors.end(), [&](auto x, auto y) {
+            return position.at(x) > position.at(y);
+        });
+        std::unordered_set<instruction_ref> new_dead = {ins};
+        std::size_t freed_bytes                      = 0;
+        for(auto a : ancestors)
+        {
+            if(not std::all_of(a->outputs().begin(), a->outputs().end(), [&](auto out) {
+                   return contains(dead, out) or contains(new_dead, out);
+               }))
+                continue;
+            new_dead.insert(a);
+            if(a->name() == "@literal")
+                freed_bytes += a->get_shape().bytes();
+        }
+        auto bytes = ins->get_shape().bytes();
+        if(bytes > freed_bytes)
+        {
+            if(literal_bytes + bytes - freed_bytes > memory_budget)
+                continue;
+        }
+        literal_bytes = literal_bytes + bytes - freed_bytes;
+        dead.insert(new_dead.begin(), new_dead.end());
+        const_instrs.push_back(ins);
+    }
+}
+
 argument as_packed(const argument& c)
 {
     if(c.get_shape().packed())
@@ -96,6 +161,8 @@ void propagate_constant::apply(module& m) const
 
     // Compute literals in parallel
     std::vector<instruction_ref> const_instrs_vec{const_instrs.begin(), const_instrs.end()};
+    if(memory_budget > 0)
+        apply_memory_budget(m, const_instrs_vec, memory_budget);
     std::vector<argument> literals(const_instrs_vec.size());
     std::size_t grainsize = 1;
 #if !MIGRAPHX_HAS_EXECUTORS
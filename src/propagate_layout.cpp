@@ -0,0 +1,168 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/propagate_layout.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/permutation.hpp>
+#include <migraphx/algorithm.hpp>
+#include <migraphx/ranges.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+static bool is_transpose(instruction_ref ins) { return ins->name() == "transpose"; }
+
+static std::vector<int64_t> get_permutation(instruction_ref ins)
+{
+    return ins->get_operator().to_value()["permutation"].to_vector<int64_t>();
+}
+
+static bool is_reduce(instruction_ref ins)
+{
+    return ins->get_operator().attributes().contains("reduce");
+}
+
+static bool is_pointwise(instruction_ref ins)
+{
+    return ins->get_operator().attributes().contains("pointwise");
+}
+
+// Inputs that can be permuted back without copying any data
+static bool is_permutable_input(instruction_ref input, const std::vector<int64_t>& perm)
+{
+    if(input->can_eval())
+        return true;
+    const auto& s = input->get_shape();
+    if(s.scalar() or s.broadcasted())
+        return true;
+    return is_transpose(input) and get_permutation(input) == perm;
+}
+
+static bool
+can_move_past(instruction_ref ins, instruction_ref input, const std::vector<int64_t>& perm)
+{
+    if(ins->get_shape().dynamic() or not ins->module_inputs().empty())
+        return false;
+    if(is_reduce(ins))
+        return ins->inputs().size() == 1;
+    if(not is_pointwise(ins))
+        return false;
+    return all_of(ins->inputs(),
+                  [&](auto x) { return x == input or is_permutable_input(x, perm); });
+}
+
+// Number of bytes copied when the transpose applied to a standard tensor is
+// made contiguous
+static std::size_t copy_cost(const shape& transposed, const std::vector<int64_t>& perm)
+{
+    auto s = shape{transposed.type(), reorder_dims(transposed.lens(), invert_permutation(perm))};
+    if(make_op("transpose", {{"permutation", perm}}).compute_shape({s}).standard())
+        return 0;
+    return s.bytes();
+}
+
+static instruction_ref permute_input(module& m,
+                                     instruction_ref pos,
+                                     instruction_ref input,
+                                     const std::vector<int64_t>& perm)
+{
+    if(is_transpose(input) and get_permutation(input) == perm)
+        return input->inputs().front();
+    return m.insert_instruction(
+        pos, make_op("transpose", {{"permutation", invert_permutation(perm)}}), input);
+}
+
+static operation permute_operator(instruction_ref ins, const std::vector<int64_t>& perm)
+{
+    if(not is_reduce(ins))
+        return ins->get_operator();
+    auto v    = ins->get_operator().to_value();
+    auto axes = v["axes"].to_vector<int64_t>();
+    auto ndim = static_cast<int64_t>(perm.size());
+    std::transform(axes.begin(), axes.end(), axes.begin(), [&](auto axis) {
+        return perm[axis < 0 ? axis + ndim : axis];
+    });
+    std::sort(axes.begin(), axes.end());
+    v["axes"] = axes;
+    return make_op(ins->name(), v);
+}
+
+void propagate_layout::apply(module& m) const
+{
+    for(auto ins : iterator_for(m))
+    {
+        if(not is_transpose(ins) or ins->get_shape().dynamic())
+            continue;
+        auto input = ins->inputs().front();
+        if(not input->get_shape().standard())
+            continue;
+        auto perm = get_permutation(ins);
+        // Walk down the single users and find where materializing the
+        // transpose is cheapest
+        std::vector<instruction_ref> chain;
+        std::size_t best_cost = copy_cost(ins->get_shape(), perm);
+        std::size_t best      = 0;
+        auto current          = ins;
+        while(best_cost > 0 and current->outputs().size() == 1)
+        {
+            auto next = current->outputs().front();
+            if(is_transpose(next) and get_permutation(next) == invert_permutation(perm))
+            {
+                best      = chain.size();
+                best_cost = 0;
+                break;
+            }
+            if(not can_move_past(next, current, perm))
+                break;
+            chain.push_back(next);
+            auto cost = copy_cost(next->get_shape(), perm);
+            if(cost < best_cost)
+            {
+                best      = chain.size();
+                best_cost = cost;
+            }
+            current = next;
+        }
+        if(best == 0)
+            continue;
+        auto x    = input;
+        auto prev = ins;
+        for(auto c : range(chain.begin(), chain.begin() + best))
+        {
+            std::vector<instruction_ref> inputs;
+            std::transform(c->inputs().begin(),
+                           c->inputs().end(),
+                           std::back_inserter(inputs),
+                           [&](auto i) { return i == prev ? x : permute_input(m, c, i, perm); });
+            x    = m.insert_instruction(c, permute_operator(c, perm), inputs);
+            prev = c;
+        }
+        m.replace_instruction(prev, make_op("transpose", {{"permutation", perm}}), x);
+    }
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
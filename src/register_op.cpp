@@ -28,15 +28,26 @@
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
-std::unordered_map<std::string, operation>& op_map()
+struct registered_op
 {
-    static std::unordered_map<std::string, operation> m; // NOLINT
+    operation op;
+    op_field_setter setter;
+};
+
+std::unordered_map<std::string, registered_op>& op_map()
+{
+    static std::unordered_map<std::string, registered_op> m; // NOLINT
     return m;
 }
 
 void register_op_init() { (void)op_map(); }
 
-void register_op(const operation& op) { op_map()[op.name()] = op; }
+void register_op(const operation& op) { register_op(op, nullptr); }
+
+void register_op(const operation& op, op_field_setter setter)
+{
+    op_map()[op.name()] = registered_op{op, std::move(setter)};
+}
 
 void unregister_op(const std::string& op_name)
 {
@@ -46,7 +57,15 @@ void unregister_op(const std::string& op_name)
 
 operation load_op(const std::string& name)
 {
-    return at(op_map(), name, "Operator not found: " + name);
+    return at(op_map(), name, "Operator not found: " + name).op;
+}
+
+op_field_setter get_op_field_setter(const std::string& name)
+{
+    auto it = op_map().find(name);
+    if(it == op_map().end())
+        return nullptr;
+    return it->second.setter;
 }
 
 bool has_op(const std::string& name) { return op_map().count(name) == 1; }
@@ -65,7 +65,7 @@ struct stream_info
     std::unordered_map<instruction_ref, std::size_t> iweights;
     ins_dep_map mod_implicit_deps;
 
-    void calc_implicit_deps(const module& m) { mod_implicit_deps = m.calc_implicit_deps(); }
+    void calc_implicit_deps(const module& m) { mod_implicit_deps = m.get_implicit_deps(); }
 
     void accumulate_weights(instruction_ref last, const schedule_model& model)
     {
@@ -360,7 +360,8 @@ struct stream_info
         return different(get_streams_from(ins, get_outputs()), xs...);
     }
 
-    std::vector<instruction_ref> get_recorded_instructions(instruction_ref start)
+    std::vector<instruction_ref> get_recorded_instructions(const module& mod,
+                                                           instruction_ref start)
     {
         std::vector<instruction_ref> result;
         std::unordered_map<std::size_t, instruction_ref> m;
@@ -376,9 +377,8 @@ struct stream_info
                 if(not contains(m, stream))
                     m[stream] = i;
                 else
-                    m[stream] = std::min(m[stream], i, by(std::less<>{}, [&](auto x) {
-                                             return std::distance(x, start);
-                                         }));
+                    m[stream] = std::max(
+                        m[stream], i, [&](auto x, auto y) { return mod.precedes(x, y); });
             }
         })(start);
         std::transform(
@@ -391,7 +391,7 @@ struct stream_info
     {
         std::unordered_map<instruction_ref, std::vector<std::vector<instruction_ref>>> result;
         std::unordered_map<instruction_ref, std::unordered_set<instruction_ref>> merge_from;
-        dominator_info di = compute_dominator(m);
+        const auto& di = m.get_dominator_info();
         result.reserve(m.size());
         merge_from.reserve(m.size());
         for(auto ins : reverse_iterator_for(m))
@@ -586,7 +586,7 @@ void schedule::apply(module& m) const
         // Insert wait instructions
         if(si.is_merge_point(ins, stream))
         {
-            for(auto i : si.get_recorded_instructions(ins))
+            for(auto i : si.get_recorded_instructions(m, ins))
             {
                 if(not si.has_stream(i) or si.get_stream(i) == stream)
                     continue;
@@ -27,6 +27,10 @@
 #include <migraphx/serialize.hpp>
 #include <migraphx/permutation.hpp>
 #include <migraphx/ranges.hpp>
+#include <migraphx/hash.hpp>
+#include <array>
+#include <atomic>
+#include <mutex>
 #include <numeric>
 #include <algorithm>
 #include <functional>
@@ -66,12 +70,20 @@ struct shape_impl
 
         // Calculate standard shape flag for these lens/strides.  Strides on size-1
         // axes are ignored to support an MLIR rule.
-        std::vector<size_t> filtered_strides;
-        for(size_t ind = 0; ind < m_strides.size(); ind++)
-            if(m_lens[ind] != 1)
-                filtered_strides.push_back(m_strides[ind]);
-        m_standard = this->elements() == this->element_space() and not skips() and
-                     std::is_sorted(filtered_strides.rbegin(), filtered_strides.rend());
+        bool sorted      = true;
+        std::size_t last = 0;
+        for(auto i : reverse(range(m_lens.size())))
+        {
+            if(m_lens[i] == 1)
+                continue;
+            if(m_strides[i] < last)
+            {
+                sorted = false;
+                break;
+            }
+            last = m_strides[i];
+        }
+        m_standard = sorted and this->elements() == this->element_space() and not skips();
     }
 
     shape_impl(shape::type_t t, std::vector<shape::dynamic_dimension> dims)
@@ -109,6 +121,9 @@ struct shape_impl
     std::vector<std::size_t> m_strides = {};
     std::vector<shape> m_shapes        = {};
     bool m_standard                    = false;
+    // Set when this is the canonical impl in the intern table, so two interned
+    // impls at different addresses are never equal
+    bool m_interned = false;
 
     std::vector<shape::dynamic_dimension> m_dyn_dims = {};
 
@@ -224,9 +239,131 @@ struct shape_impl
         return std::none_of(m_strides.begin(), m_strides.end(), [](auto x) { return x == 1; });
     }
 
-    std::shared_ptr<shape_impl> copy() const { return std::make_shared<shape_impl>(*this); }
+    std::shared_ptr<shape_impl> copy() const
+    {
+        auto result        = std::make_shared<shape_impl>(*this);
+        result->m_interned = false;
+        return result;
+    }
 };
 
+// Static shapes with at most this many dimensions are interned
+constexpr std::size_t max_interned_ndim = 6;
+// Past this many entries new shapes are no longer interned
+constexpr std::size_t max_interned_shapes = 1u << 16u;
+
+// Table of canonical impls for static shapes, so the common shapes are only
+// allocated once and compare by pointer. It is split in shards to limit the
+// contention between threads.
+struct shape_intern_table
+{
+    struct shard
+    {
+        std::mutex m;
+        std::unordered_multimap<std::size_t, std::shared_ptr<shape_impl>> impls;
+    };
+    std::array<shard, 16> shards;
+    std::atomic<std::size_t> size{0};
+};
+
+// Shapes can be held by other static objects so the table is never destroyed
+static shape_intern_table& get_intern_table()
+{
+    static auto* table = new shape_intern_table{}; // NOLINT
+    return *table;
+}
+
+// Call f with each stride in order, computing the standard strides when none
+// are given
+template <class F>
+static void for_each_stride(const std::vector<std::size_t>& lens,
+                            const std::vector<std::size_t>& strides,
+                            F f)
+{
+    if(not strides.empty())
+    {
+        for(auto i : range(lens.size()))
+            f(i, strides[i]);
+        return;
+    }
+    assert(lens.size() <= max_interned_ndim);
+    std::array<std::size_t, max_interned_ndim> standard_strides{};
+    std::size_t stride = 1;
+    for(auto i : reverse(range(lens.size())))
+    {
+        standard_strides[i] = stride;
+        stride *= lens[i];
+    }
+    for(auto i : range(lens.size()))
+        f(i, standard_strides[i]);
+}
+
+static std::size_t hash_static_shape(shape::type_t t,
+                                     const std::vector<std::size_t>& lens,
+                                     const std::vector<std::size_t>& strides)
+{
+    std::size_t h = hash_value(static_cast<int>(t));
+    for(auto len : lens)
+        hash_combine(h, len);
+    for_each_stride(lens, strides, [&](auto, auto stride) { hash_combine(h, stride); });
+    return h;
+}
+
+static bool same_static_shape(const shape_impl& impl,
+                              shape::type_t t,
+                              const std::vector<std::size_t>& lens,
+                              const std::vector<std::size_t>& strides)
+{
+    if(impl.m_type != t or impl.m_lens != lens)
+        return false;
+    bool result = true;
+    for_each_stride(lens, strides, [&](auto i, auto stride) {
+        result = result and impl.m_strides[i] == stride;
+    });
+    return result;
+}
+
+// Return the interned impl for a static shape, creating it if needed. Empty
+// strides mean the standard strides for the lens.
+static std::shared_ptr<shape_impl> make_static_impl(shape::type_t t,
+                                                    std::vector<std::size_t> lens,
+                                                    std::vector<std::size_t> strides)
+{
+    auto make = [&] {
+        if(strides.empty())
+            return std::make_shared<shape_impl>(t, std::move(lens));
+        return std::make_shared<shape_impl>(t, std::move(lens), std::move(strides));
+    };
+    if(lens.size() > max_interned_ndim or (not strides.empty() and strides.size() != lens.size()))
+        return make();
+    auto h = hash_static_shape(t, lens, strides);
+    // Shapes recently interned by this thread, so shapes built over and over,
+    // like in the body of a par_for, are found without taking a lock
+    thread_local std::array<std::shared_ptr<shape_impl>, 64> recent{};
+    auto& cached = recent[h % recent.size()];
+    if(cached != nullptr and same_static_shape(*cached, t, lens, strides))
+        return cached;
+    auto& table = get_intern_table();
+    auto& s     = table.shards[h % table.shards.size()];
+    std::lock_guard<std::mutex> lock(s.m);
+    for(auto [it, last] = s.impls.equal_range(h); it != last; ++it)
+    {
+        if(not same_static_shape(*it->second, t, lens, strides))
+            continue;
+        cached = it->second;
+        return cached;
+    }
+    auto result = make();
+    if(table.size < max_interned_shapes)
+    {
+        table.size++;
+        result->m_interned = true;
+        s.impls.emplace(h, result);
+        cached = result;
+    }
+    return result;
+}
+
 std::string shape::to_sizes_string(const std::vector<shape>& shapes)
 {
     std::vector<std::string> sizes;
@@ -313,15 +450,14 @@ bool shape::is_unsigned(shape::type_t t)
 
 shape::shape() : impl(shape_impl::default_shape()) {}
 
-shape::shape(type_t t) : impl(std::make_shared<shape_impl>(t)) {}
+shape::shape(type_t t) : impl(make_static_impl(t, {1}, {0})) {}
 
-shape::shape(type_t t, std::vector<std::size_t> l)
-    : impl(std::make_shared<shape_impl>(t, std::move(l)))
+shape::shape(type_t t, std::vector<std::size_t> l) : impl(make_static_impl(t, std::move(l), {}))
 {
 }
 
 shape::shape(type_t t, std::vector<std::size_t> l, std::vector<std::size_t> s)
-    : impl(std::make_shared<shape_impl>(t, std::move(l), std::move(s)))
+    : impl(make_static_impl(t, std::move(l), std::move(s)))
 {
 }
 
@@ -737,6 +873,10 @@ shape::dynamic_dimension operator-(const shape::dynamic_dimension& x, const std:
 
 bool operator==(const shape& x, const shape& y)
 {
+    if(x.impl == y.impl)
+        return true;
+    if(x.impl->m_interned and y.impl->m_interned)
+        return false;
     if(x.dynamic() and y.dynamic())
     {
         return x.impl == y.impl or (x.type() == y.type() and x.dyn_dims() == y.dyn_dims() and
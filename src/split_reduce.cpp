@@ -81,11 +81,9 @@ struct splitter
 {
     const_module_ref rm;
 
-    bool strictly_dominate(instruction_ref a, instruction_ref b)
+    bool strictly_dominate(instruction_ref a, instruction_ref b) const
     {
-        if(not dom.has_value())
-            dom = compute_dominator(*rm);
-        return dom->strictly_dominate(a, b);
+        return rm->get_dominator_info().strictly_dominate(a, b);
     }
 
     std::vector<instruction_ref> find_splits() const
@@ -141,7 +139,6 @@ struct splitter
         return result;
     }
 
-    std::optional<dominator_info> dom = std::nullopt;
 };
 } // namespace
 
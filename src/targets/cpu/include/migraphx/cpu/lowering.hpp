@@ -35,6 +35,13 @@ namespace cpu {
 
 struct MIGRAPHX_CPU_EXPORT lowering
 {
+    context* ctx = nullptr;
+    // Fused reductions over fewer elements than this are split back into
+    // separate operators
+    std::size_t min_fused_reduce_elements = 256;
+    // Constant dot weights with at least this fraction of zeros are stored
+    // in compressed sparse row format
+    float min_sparse_dot_sparsity = 0.75;
     std::string name() const { return "cpu::lowering"; }
     void apply(module& m) const;
 };
@@ -48,6 +48,8 @@
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/par_dfor.hpp>
 #include <migraphx/clamp.hpp>
+#include <migraphx/float_equal.hpp>
+#include <migraphx/literal.hpp>
 #include <migraphx/cpu/context.hpp>
 #include <migraphx/register_op.hpp>
 #include <migraphx/make_op.hpp>
@@ -57,6 +59,9 @@
 #include <migraphx/match/gelu_erf.hpp>
 #include <migraphx/match/gelu_tanh.hpp>
 #include <migraphx/matcher.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/stringutils.hpp>
+#include <numeric>
 #include <unordered_map>
 #include <utility>
 #include <iostream>
@@ -65,6 +70,8 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_DNNL_POST_OPS_WORKAROUND);
+
 template <typename T>
 T zero(const T&)
 {
@@ -265,6 +272,9 @@ MIGRAPHX_REGISTER_OP(cpu_rnn_var_sl_last_output)
 struct cpu_apply
 {
     module* modl;
+    context* ctx                          = nullptr;
+    std::size_t min_fused_reduce_elements = 0;
+    float min_sparse_dot_sparsity         = 1;
     std::unordered_map<std::string, std::function<instruction_ref(instruction_ref)>> apply_map{};
     instruction_ref last{};
 
@@ -311,6 +321,56 @@ struct cpu_apply
         });
     }
 
+    // Quantization is rewritten as a scale, a round, an optional zero point
+    // shift and a clip. Fuse the chain into one dnnl::binary with post ops,
+    // so the input to a quantized gemm is produced in a single pass.
+    auto find_quantize()
+    {
+        auto scale = match::name("mul", "div")(match::used_once()).bind("scale");
+        auto round = match::name("nearbyint")(match::used_once(), match::arg(0)(scale));
+        auto shift = match::name("add")(match::used_once(), match::arg(0)(round)).bind("shift");
+        return match::make_match_finder(
+            match::name("clip")(match::arg(0)(match::any_of(round, shift))),
+            [=](auto&, const auto& r) {
+                // Chained post ops are only trusted under the same switch as
+                // fuse_ops
+                if(ctx == nullptr or not enabled(MIGRAPHX_DISABLE_DNNL_POST_OPS_WORKAROUND{}))
+                    return;
+                auto ins       = r.result;
+                auto scale_ins = r.instructions["scale"];
+                auto lo        = read_scalar<float>(ins->inputs()[1]);
+                auto hi        = read_scalar<float>(ins->inputs()[2]);
+                if(lo.empty() or hi.empty())
+                    return;
+                auto algo   = scale_ins->name() == "mul" ? "binary_mul" : "binary_div";
+                auto inputs = scale_ins->inputs();
+                value post_ops;
+                post_ops.push_back({{"algo", "eltwise_round"}, {"alpha", 0.0f}, {"beta", 0.0f}});
+                if(r.instructions.find("shift") != r.instructions.end())
+                {
+                    // dnnl computes a binary post op with an operand laid out
+                    // like the output as an append_sum, which is wrong here
+                    auto zero_point = r.instructions["shift"]->inputs()[1];
+                    if(zero_point->get_shape().lens() == ins->get_shape().lens() and
+                       zero_point->get_shape().strides() == ins->get_shape().strides())
+                        return;
+                    post_ops.push_back(
+                        {{"algo", "binary_add"}, {"alpha", 0.0f}, {"beta", 0.0f}});
+                    inputs.push_back(zero_point);
+                }
+                post_ops.push_back(
+                    {{"algo", "eltwise_clip"}, {"alpha", lo.front()}, {"beta", hi.front()}});
+                auto input_shapes = to_shapes(inputs);
+                input_shapes.push_back(ins->get_shape());
+                auto op = make_op("dnnl::binary", {{"algo", algo}, {"post_ops", post_ops}});
+                auto info = compile(op, *ctx, ins->get_shape(), input_shapes);
+                if(info.contains("impl") and starts_with(info.at("impl").to<std::string>(), "ref:"))
+                    return;
+                inputs.push_back(this->insert_allocation(ins, ins->get_shape()));
+                modl->replace_instruction(ins, op, inputs);
+            });
+    }
+
     void init()
     {
         extend_dnnl_algos("dnnl::binary",
@@ -362,6 +422,18 @@ struct cpu_apply
     void apply()
     {
         init();
+        // Pointwise modules that were not fused into a reduction, and
+        // reductions too small to benefit from fusion, are split back into
+        // separate operators so they can be lowered below
+        for(auto it : iterator_for(*modl))
+        {
+            if(it->name() != "pointwise" and
+               (it->name() != "fused_reduce" or reduce_elements(it) >= min_fused_reduce_elements))
+                continue;
+            modl->replace_instruction(
+                it,
+                insert_inline(it, it->get_operator(), *it->module_inputs().front(), it->inputs()));
+        }
         // Apply fusion matchers first
         match::find_matches(*modl,
                             fuse_match(match::gelu_erf(),
@@ -370,7 +442,8 @@ struct cpu_apply
                             fuse_match(match::gelu_tanh(),
                                        make_op("dnnl::eltwise", {{"algo", "eltwise_gelu_tanh"}}),
                                        {"x"}),
-                            fuse_match(match::layernorm(), make_op("dnnl::layernorm"), {"x"}));
+                            fuse_match(match::layernorm(), make_op("dnnl::layernorm"), {"x"}),
+                            find_quantize());
         // Apply these operators first so the inputs can be const folded
         for(auto it : iterator_for(*modl))
         {
@@ -384,6 +457,10 @@ struct cpu_apply
             {
                 apply_pow(it);
             }
+            else if(it->name() == "dot")
+            {
+                apply_sparse_dot(it);
+            }
         }
         for(auto it : iterator_for(*modl))
         {
@@ -408,6 +485,52 @@ struct cpu_apply
         }
     }
 
+    static std::size_t reduce_elements(instruction_ref ins)
+    {
+        auto axes        = ins->get_operator().to_value()["axes"].to_vector<std::int64_t>();
+        const auto& lens = ins->inputs().front()->get_shape().lens();
+        return std::accumulate(axes.begin(), axes.end(), std::size_t{1}, [&](auto n, auto axis) {
+            return n * lens[axis];
+        });
+    }
+
+    instruction_ref insert_inline(instruction_ref pos,
+                                  const operation& op,
+                                  const module& m,
+                                  const std::vector<instruction_ref>& inputs) const
+    {
+        std::unordered_map<instruction_ref, instruction_ref> map_ins;
+        if(op.name() == "pointwise")
+        {
+            // Literals in pointwise modules are scalars
+            auto lens = inputs.front()->get_shape().lens();
+            for(auto ins : iterator_for(m))
+            {
+                if(ins->name() != "@literal")
+                    continue;
+                map_ins[ins] =
+                    modl->insert_instruction(pos,
+                                             make_op("multibroadcast", {{"out_lens", lens}}),
+                                             modl->add_literal(ins->get_literal()));
+            }
+        }
+        return modl
+            ->insert_inline(pos,
+                            m,
+                            inputs,
+                            &map_ins,
+                            [&](module& mm,
+                                instruction_ref ins,
+                                const operation& sop,
+                                const std::vector<instruction_ref>& xs,
+                                const std::vector<module_ref>& mod_args) {
+                                if(sop.name() == "pointwise")
+                                    return insert_inline(ins, sop, *mod_args.front(), xs);
+                                return mm.insert_instruction(ins, sop, xs, mod_args);
+                            })
+            .front();
+    }
+
     instruction_ref apply_pow(instruction_ref ins) const
     {
         auto beta = read_scalar<float>(ins->inputs()[1]);
@@ -419,6 +542,54 @@ struct cpu_apply
                        {ins->inputs().front()});
     }
 
+    // Compress constant weights that are mostly zeros, which is common for
+    // pruned models, so the product only reads and computes the nonzeros
+    instruction_ref apply_sparse_dot(instruction_ref ins) const
+    {
+        auto a = ins->inputs()[0];
+        auto b = ins->inputs()[1];
+        // Weights are broadcast across the batch dimensions
+        auto w = b->name() == "multibroadcast" ? b->inputs().front() : b;
+        if(w->name() != "@literal" or not w->get_shape().standard() or
+           w->get_shape().lens().size() != 2 or not a->get_shape().standard() or
+           a->get_shape().type() != shape::float_type)
+            return ins;
+        const auto& b_lens = b->get_shape().lens();
+        if(not std::equal(w->get_shape().lens().begin(),
+                          w->get_shape().lens().end(),
+                          b_lens.end() - 2))
+            return ins;
+        auto k = b_lens[b_lens.size() - 2];
+        auto n = b_lens.back();
+        std::vector<float> values;
+        std::vector<std::int32_t> columns;
+        std::vector<std::int64_t> offsets{0};
+        w->get_literal().visit([&](auto weights) {
+            for(std::size_t i = 0; i < k; i++)
+            {
+                for(std::size_t j = 0; j < n; j++)
+                {
+                    if(float_equal(weights(i, j), 0))
+                        continue;
+                    values.push_back(weights(i, j));
+                    columns.push_back(std::int32_t(j));
+                }
+                offsets.push_back(std::int64_t(values.size()));
+            }
+        });
+        if(values.empty() or values.size() > (1 - min_sparse_dot_sparsity) * k * n)
+            return ins;
+        auto values_lit =
+            modl->add_literal(literal{shape{shape::float_type, {values.size()}}, values});
+        auto columns_lit =
+            modl->add_literal(literal{shape{shape::int32_type, {columns.size()}}, columns});
+        auto offsets_lit =
+            modl->add_literal(literal{shape{shape::int64_type, {offsets.size()}}, offsets});
+        return replace(ins,
+                       make_op("cpu::sparse_dot", {{"n", n}}),
+                       {a, values_lit, columns_lit, offsets_lit});
+    }
+
     // TODO:  update lowering to run the reference
     // code when OneDNN can't execute pooling for a CPU
 
@@ -494,7 +665,10 @@ struct cpu_apply
     }
 };
 
-void lowering::apply(module& m) const { cpu_apply{&m}.apply(); }
+void lowering::apply(module& m) const
+{
+    cpu_apply{&m, ctx, min_fused_reduce_elements, min_sparse_dot_sparsity}.apply();
+}
 
 } // namespace cpu
 } // namespace MIGRAPHX_INLINE_NS
@@ -0,0 +1,110 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/register_op.hpp>
+#include <algorithm>
+#include <cstdint>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// Multiplies a dense input by a constant {k, n} weight stored in compressed
+// sparse row format. The inputs are the dense input, the nonzero values,
+// their column indices, the k + 1 row offsets and the output allocation.
+struct cpu_sparse_dot : auto_register_op<cpu_sparse_dot>
+{
+    std::size_t n = 0;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.n, "n"));
+    }
+
+    std::string name() const { return "cpu::sparse_dot"; }
+    shape compute_shape(const std::vector<shape>& inputs) const
+    {
+        check_shapes{inputs, *this}.has(5).standard();
+        const auto& a       = inputs[0];
+        const auto& values  = inputs[1];
+        const auto& columns = inputs[2];
+        const auto& offsets = inputs[3];
+        if(a.lens().size() < 2)
+            MIGRAPHX_THROW("SPARSE_DOT: input must have at least 2 dimensions");
+        if(values.type() != a.type() or columns.type() != shape::int32_type or
+           offsets.type() != shape::int64_type)
+            MIGRAPHX_THROW("SPARSE_DOT: invalid types for the sparse weights");
+        if(values.elements() != columns.elements() or offsets.elements() != a.lens().back() + 1)
+            MIGRAPHX_THROW("SPARSE_DOT: sparse weights do not match the input");
+        auto lens   = a.lens();
+        lens.back() = n;
+        return {a.type(), lens};
+    }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>& args) const
+    {
+        auto k    = args[0].get_shape().lens().back();
+        auto rows = args[0].get_shape().elements() / k;
+        auto cols = n;
+        visit_all(args.back(), args[0], args[1])([&](auto output, auto input, auto values) {
+            using type              = typename decltype(output)::value_type;
+            auto* output_ptr        = output.data();
+            const auto* input_ptr   = input.data();
+            const auto* values_ptr  = values.data();
+            const auto* columns_ptr = args[2].get<std::int32_t>().data();
+            const auto* offsets_ptr = args[3].get<std::int64_t>().data();
+            // Each row of the output accumulates the sparse rows of the weights
+            // scaled by the matching input element, so the weights are read in
+            // order and zeros are never touched
+            ctx.bulk_execute(rows, 1, [=](auto start, auto end) {
+                for(auto i = start; i < end; i++)
+                {
+                    auto* out      = output_ptr + i * cols;
+                    const auto* in = input_ptr + i * k;
+                    std::fill(out, out + cols, type(0));
+                    for(std::size_t j = 0; j < k; j++)
+                    {
+                        auto x = in[j];
+                        for(auto p = offsets_ptr[j]; p < offsets_ptr[j + 1]; p++)
+                            out[columns_ptr[p]] += x * values_ptr[p];
+                    }
+                }
+            });
+        });
+        return args.back();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
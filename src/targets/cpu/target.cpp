@@ -30,11 +30,16 @@
 #include <migraphx/eliminate_concat.hpp>
 #include <migraphx/eliminate_contiguous.hpp>
 #include <migraphx/eliminate_data_type.hpp>
+#include <migraphx/eliminate_duplicate_literals.hpp>
 #include <migraphx/eliminate_identity.hpp>
 #include <migraphx/eliminate_pad.hpp>
 #include <migraphx/eliminate_convert.hpp>
+#include <migraphx/fuse_pointwise.hpp>
+#include <migraphx/fuse_reduce.hpp>
+#include <migraphx/group_dots.hpp>
 #include <migraphx/memory_coloring.hpp>
 #include <migraphx/propagate_constant.hpp>
+#include <migraphx/propagate_layout.hpp>
 #include <migraphx/register_target.hpp>
 #include <migraphx/replace_allocate.hpp>
 #include <migraphx/rewrite_pooling.hpp>
@@ -43,10 +48,12 @@
 #include <migraphx/schedule.hpp>
 #include <migraphx/simplify_algebra.hpp>
 #include <migraphx/simplify_reshapes.hpp>
+#include <migraphx/unroll_loop.hpp>
 #include <migraphx/preallocate_param.hpp>
 #include <migraphx/cpu/fuse_ops.hpp>
 #include <migraphx/cpu/write_literals.hpp>
 #include <migraphx/cpu/allocation_model.hpp>
+#include <migraphx/cpu/concat_cpu_opt.hpp>
 #include <migraphx/cpu/target.hpp>
 #include <migraphx/cpu/context.hpp>
 #include <migraphx/cpu/lowering.hpp>
@@ -61,7 +68,7 @@ namespace cpu {
 std::string target::name() const { return "cpu"; }
 
 // cppcheck-suppress constParameterReference
-std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_options&) const
+std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_options& options) const
 {
     auto& ctx = any_cast<context>(gctx);
     std::set<shape::type_t> unsupported_types(shape::types().begin(), shape::types().end());
@@ -80,6 +87,8 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             dead_code_elimination{},
             rewrite_rnn{},
             dead_code_elimination{},
+            unroll_loop{},
+            dead_code_elimination{},
             eliminate_common_subexpression{},
             dead_code_elimination{},
             simplify_algebra{},
@@ -93,10 +102,20 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             simplify_reshapes{},
             eliminate_convert{},
             dead_code_elimination{},
-            propagate_constant{},
+            propagate_layout{},
+            dead_code_elimination{},
+            simplify_reshapes{},
+            dead_code_elimination{},
+            group_dots{},
+            dead_code_elimination{},
+            propagate_constant{{}, options.memory_budget},
+            dead_code_elimination{},
+            eliminate_duplicate_literals{},
+            fuse_pointwise{.enable_rewrite_reshapes = false},
+            fuse_reduce{.enable_rewrite_reshapes = false},
             dead_code_elimination{},
             auto_contiguous{},
-            lowering{},
+            lowering{&ctx},
             eliminate_contiguous{"dnnl::reorder"},
             dead_code_elimination{},
             replace_allocate{cpu_allocation_model{}},
@@ -105,6 +124,8 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             dead_code_elimination{},
             fuse_ops{&ctx},
             dead_code_elimination{},
+            eliminate_concat{concat_cpu_optimization{}},
+            dead_code_elimination{},
             write_literals{},
             dead_code_elimination{},
             memory_coloring{"cpu::allocate"},
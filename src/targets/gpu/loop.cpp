@@ -34,6 +34,10 @@ namespace gpu {
 
 shape hip_loop::compute_shape(std::vector<shape> inputs, std::vector<module_ref> mods) const
 {
+    // The gpu loop preallocates its scan outputs for max_iterations, so it
+    // cannot return a dynamic number of iterations
+    if(op.trim_scan_outputs)
+        MIGRAPHX_THROW("GPU_LOOP: trim_scan_outputs is not supported");
     auto input_num = (inputs.size() - 2) / 2;
     inputs.erase(inputs.begin() + input_num, inputs.end());
     return op.compute_shape(inputs, std::move(mods));
@@ -42,6 +46,8 @@ shape hip_loop::compute_shape(std::vector<shape> inputs, std::vector<module_ref>
 struct gpu_loop
 {
     int64_t max_iterations = 0;
+    // trimmed scan outputs are rejected in hip_loop::compute_shape
+    bool trim_scan_outputs = false;
 
     template <class T>
     void copy(context& ctx, const argument& src, T& dst) const
@@ -85,28 +91,7 @@ struct gpu_loop
 
     std::unordered_map<std::string, int> get_output_params(const module& m) const
     {
-        auto get_output_index = [](const std::string& name) {
-            std::string out_prefix = "#output_";
-            auto loc               = name.find(out_prefix);
-            if(loc != std::string::npos)
-            {
-                return std::stoi(name.substr(loc + out_prefix.size()));
-            }
-
-            return -1;
-        };
-
-        const auto& param_names = m.get_parameter_names();
-        std::unordered_map<std::string, int> result;
-        for(const auto& name : param_names)
-        {
-            auto index = get_output_index(name);
-            if(index == -1)
-                continue;
-            result[name] = index;
-        }
-
-        return result;
+        return get_loop_output_params(m);
     }
 };
 
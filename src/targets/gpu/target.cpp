@@ -29,6 +29,7 @@
 #include <migraphx/eliminate_concat.hpp>
 #include <migraphx/eliminate_contiguous.hpp>
 #include <migraphx/eliminate_data_type.hpp>
+#include <migraphx/eliminate_duplicate_literals.hpp>
 #include <migraphx/eliminate_identity.hpp>
 #include <migraphx/eliminate_pad.hpp>
 #include <migraphx/fuse_concat.hpp>
@@ -55,6 +56,7 @@
 #include <migraphx/simplify_reshapes.hpp>
 #include <migraphx/split_reduce.hpp>
 #include <migraphx/split_single_dyn_dim.hpp>
+#include <migraphx/unroll_loop.hpp>
 #include <migraphx/gpu/allocation_model.hpp>
 #include <migraphx/gpu/compile_hipblaslt.hpp>
 #include <migraphx/gpu/compile_miopen.hpp>
@@ -194,10 +196,12 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
         rewrite_rnn{},
         dead_code_elimination{},
         inline_module{},
+        unroll_loop{},
+        dead_code_elimination{},
         rewrite_pooling{},
         dead_code_elimination{},
         rewrite_gelu{options.fast_math},
-        optimize_module{},
+        optimize_module{.memory_budget = options.memory_budget},
         layout_convolution{.channels_last = enabled(MIGRAPHX_ENABLE_NHWC{})},
         dead_code_elimination{},
         prefuse_ops{},
@@ -209,7 +213,8 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
         rewrite_reduce{},
         rewrite_low_precision{},
         dead_code_elimination{},
-        optimize_module{},
+        optimize_module{.memory_budget = options.memory_budget},
+        eliminate_duplicate_literals{},
         fuse_pointwise_reduce{},
         dead_code_elimination{},
 #ifndef _WIN32
@@ -0,0 +1,239 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/unroll_loop.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/literal.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/stringutils.hpp>
+#include <unordered_set>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+static bool is_hoistable(instruction_ref ins)
+{
+    if(starts_with(ins->name(), "@"))
+        return false;
+    if(not ins->module_inputs().empty())
+        return false;
+    if(ins->inputs().empty())
+        return false;
+    // These produce a new value each time they are evaluated
+    if(contains({"random_uniform", "random_seed", "undefined"}, ins->name()))
+        return false;
+    // Keep the outputs computed by the body
+    return std::none_of(ins->outputs().begin(), ins->outputs().end(), [](instruction_ref out) {
+        return out->name() == "@return";
+    });
+}
+
+// Instructions that cannot throw or have side effects can be evaluated
+// even when the loop does not run
+static bool is_speculatable(instruction_ref ins)
+{
+    // Integer division by zero traps
+    if(contains({"div", "mod", "fmod"}, ins->name()))
+        return false;
+    if(ins->get_operator().attributes().get("pointwise", false))
+        return true;
+    // Views only describe their input differently
+    return ins->get_operator().output_alias(to_shapes(ins->inputs())) >= 0;
+}
+
+// The number of iterations the loop runs when its trip count and initial
+// condition are constant, or 0 when it is not known to run at all
+static int64_t constant_trip_count(instruction_ref loop_ins)
+{
+    const auto& inputs = loop_ins->inputs();
+    auto arg_iters     = inputs.at(0)->eval();
+    auto arg_cond      = inputs.at(1)->eval();
+    if(arg_iters.empty() or arg_cond.empty() or not arg_cond.at<bool>())
+        return 0;
+    return std::max<int64_t>(arg_iters.at<int64_t>(), 0);
+}
+
+// Move instructions of the loop body that only depend on literals or on
+// instructions defined outside of the loop in front of the loop
+static void hoist_invariants(module& m, instruction_ref loop_ins)
+{
+    // Hoisted instructions run even when the loop does not, so unless the
+    // loop is known to run only speculatable instructions are hoisted
+    bool runs       = constant_trip_count(loop_ins) > 0;
+    module_ref body = loop_ins->module_inputs().front();
+    std::unordered_set<instruction_ref> body_ins;
+    for(auto ins : iterator_for(*body))
+        body_ins.insert(ins);
+
+    std::unordered_map<instruction_ref, instruction_ref> literals;
+    for(auto ins : iterator_for(*body))
+    {
+        if(not is_hoistable(ins))
+            continue;
+        if(not runs and not is_speculatable(ins))
+            continue;
+        const auto& inputs = ins->inputs();
+        if(std::any_of(inputs.begin(), inputs.end(), [&](instruction_ref input) {
+               return contains(body_ins, input) and input->name() != "@literal";
+           }))
+            continue;
+        std::vector<instruction_ref> new_inputs;
+        std::transform(
+            inputs.begin(), inputs.end(), std::back_inserter(new_inputs), [&](auto input) {
+                if(not contains(body_ins, input))
+                    return input;
+                if(not contains(literals, input))
+                    literals[input] = m.add_literal(input->get_literal());
+                return literals[input];
+            });
+        auto hoisted = m.insert_instruction(loop_ins, ins->get_operator(), new_inputs);
+        // Later instructions now refer to the hoisted instruction, which is
+        // not part of the body, so they can be hoisted in turn
+        body->replace_instruction(ins, hoisted);
+    }
+}
+
+static bool unroll(module& m, instruction_ref ins, const unroll_loop& p)
+{
+    auto v = ins->get_operator().to_value();
+    if(v.at("trim_scan_outputs").to<bool>())
+        return false;
+    auto max_iterations = v.at("max_iterations").to<int64_t>();
+    auto scan_dirs      = v.at("scan_output_directions").to_vector<int64_t>();
+
+    const auto& inputs = ins->inputs();
+    auto iter_num      = constant_trip_count(ins);
+    if(iter_num <= 0 or iter_num > max_iterations or iter_num > p.max_iterations)
+        return false;
+
+    module_ref body = ins->module_inputs().front();
+    if(iter_num * body->size() > p.max_instructions)
+        return false;
+    if(std::any_of(ins->outputs().begin(), ins->outputs().end(), [](instruction_ref out) {
+           return out->name() != "get_tuple_elem";
+       }))
+        return false;
+
+    auto last = std::prev(body->end());
+    if(last->name() != "@return")
+        return false;
+    auto body_outputs = last->inputs();
+
+    // Parameters of the body are the iteration number, the condition and then
+    // the loop-carried dependencies
+    std::vector<instruction_ref> params;
+    for(const auto& name : body->get_parameter_names())
+    {
+        auto param = body->get_parameter(name);
+        if(param->get_shape() == shape{})
+            return false;
+        params.push_back(param);
+    }
+    auto dep_num = inputs.size() - 2;
+    if(params.size() != dep_num + 2 or body_outputs.size() < dep_num + 1)
+        return false;
+
+    // The loop can only be unrolled if the body never stops it early
+    auto cond_out = body_outputs.front();
+    if(cond_out != params[1])
+    {
+        auto arg = cond_out->eval();
+        if(arg.empty() or not arg.at<bool>())
+            return false;
+    }
+
+    std::unordered_map<instruction_ref, instruction_ref> literals;
+    for(auto sins : iterator_for(*body))
+    {
+        if(sins->name() == "@literal")
+            literals[sins] = m.add_literal(sins->get_literal());
+    }
+
+    std::vector<instruction_ref> deps(inputs.begin() + 2, inputs.end());
+    std::vector<std::vector<instruction_ref>> scans(body_outputs.size() - dep_num - 1);
+    auto cond = m.add_literal(literal{params[1]->get_shape(), std::vector<int64_t>{1}});
+    for(int64_t i = 0; i < iter_num; ++i)
+    {
+        auto map_ins       = literals;
+        map_ins[params[0]] = m.add_literal(literal{params[0]->get_shape(), std::vector<int64_t>{i}});
+        map_ins[params[1]] = cond;
+        for(auto k : range(dep_num))
+            map_ins[params[k + 2]] = deps[k];
+        auto results = m.insert_instructions(ins, body, &map_ins);
+        std::copy(results.begin() + 1, results.begin() + 1 + dep_num, deps.begin());
+        for(auto j : range(scans.size()))
+            scans[j].push_back(results[1 + dep_num + j]);
+    }
+
+    // Stack the scan outputs along a new leading axis, padded to max_iterations
+    std::vector<instruction_ref> loop_outputs = deps;
+    for(auto j : range(scans.size()))
+    {
+        auto dir     = scan_dirs.empty() ? 0 : scan_dirs[j];
+        auto& values = scans[j];
+        if(dir == 1)
+            std::reverse(values.begin(), values.end());
+        std::vector<instruction_ref> slices;
+        std::transform(values.begin(), values.end(), std::back_inserter(slices), [&](auto x) {
+            return m.insert_instruction(ins, make_op("unsqueeze", {{"axes", {0}}}), x);
+        });
+        auto stacked = slices.size() == 1
+                           ? slices.front()
+                           : m.insert_instruction(ins, make_op("concat", {{"axis", 0}}), slices);
+        if(iter_num < max_iterations)
+        {
+            auto rank = stacked->get_shape().ndim();
+            std::vector<int64_t> pads(2 * rank, 0);
+            pads[rank] = max_iterations - iter_num;
+            stacked    = m.insert_instruction(ins, make_op("pad", {{"pads", pads}}), stacked);
+        }
+        loop_outputs.push_back(stacked);
+    }
+
+    for(auto out : ins->outputs())
+    {
+        auto index = out->get_operator().to_value().at("index").to<std::size_t>();
+        auto rep   = loop_outputs.at(index);
+        if(rep->get_shape() != out->get_shape())
+            rep = m.insert_instruction(out, make_op("contiguous"), rep);
+        m.replace_instruction(out, rep);
+    }
+    return true;
+}
+
+void unroll_loop::apply(module& m) const
+{
+    for(auto ins : iterator_for(m))
+    {
+        if(ins->name() != "loop")
+            continue;
+        hoist_invariants(m, ins);
+        unroll(m, ins, *this);
+    }
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
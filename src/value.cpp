@@ -23,7 +23,6 @@
  */
 #include <cassert>
 #include <iostream>
-#include <migraphx/cloneable.hpp>
 #include <migraphx/errors.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/value.hpp>
@@ -35,108 +34,188 @@
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
-struct value_base_impl : cloneable<value_base_impl>
+struct value_base_impl
 {
-    virtual value::type_t get_type() { return value::null_type; }
-#define MIGRAPHX_VALUE_GENERATE_BASE_FUNCTIONS(vt, cpp_type) \
-    virtual const cpp_type* if_##vt() const { return nullptr; }
-    MIGRAPHX_VISIT_VALUE_TYPES(MIGRAPHX_VALUE_GENERATE_BASE_FUNCTIONS)
-    virtual std::vector<value>* if_array() { return nullptr; }
-    virtual std::unordered_map<std::string, std::size_t>* if_object() { return nullptr; }
-    virtual value_base_impl* if_value() const { return nullptr; }
     value_base_impl()                       = default;
     value_base_impl(const value_base_impl&) = default;
     value_base_impl& operator=(const value_base_impl&) = default;
-    virtual ~value_base_impl() override {}
+    virtual ~value_base_impl() {}
 };
 
-#define MIGRAPHX_VALUE_GENERATE_BASE_TYPE(vt, cpp_type)                        \
-    struct vt##_value_holder : value_base_impl::share                          \
-    {                                                                          \
-        vt##_value_holder(cpp_type d) : data(std::move(d)) {}                  \
-        virtual value::type_t get_type() override { return value::vt##_type; } \
-        virtual const cpp_type* if_##vt() const override { return &data; }     \
-        cpp_type data;                                                         \
-    };
-MIGRAPHX_VISIT_VALUE_TYPES(MIGRAPHX_VALUE_GENERATE_BASE_TYPE)
-
-struct array_value_holder : value_base_impl::derive<array_value_holder>
-{
-    array_value_holder() {}
-    array_value_holder(std::vector<value> d) : data(std::move(d)) {}
-    virtual value::type_t get_type() override { return value::array_type; }
-    virtual std::vector<value>* if_array() override { return &data; }
-    std::vector<value> data;
+template <class T>
+struct value_holder : value_base_impl
+{
+    value_holder(T d) : data(std::move(d)) {}
+    T data;
 };
 
-struct object_value_holder : value_base_impl::derive<object_value_holder>
+// Objects with more elements than this also keep a map from key to index,
+// smaller objects are searched linearly
+constexpr std::size_t max_linear_lookup = 8;
+
+struct value_elements : value_base_impl
 {
-    object_value_holder() {}
-    object_value_holder(std::vector<value> d, std::unordered_map<std::string, std::size_t> l)
-        : data(std::move(d)), lookup(std::move(l))
+    value_elements() {}
+    value_elements(std::vector<value> d, bool object) : data(std::move(d))
+    {
+        if(object)
+            update_lookup();
+    }
+    value_elements(const value_elements& rhs)
+        : data(rhs.data), lookup(rhs.lookup), indexed(rhs.indexed)
+    {
+    }
+    value_elements& operator=(const value_elements&) = delete;
+
+    void update_lookup()
+    {
+        if(data.size() <= max_linear_lookup)
+            return;
+        for(; indexed < data.size(); indexed++)
+            lookup[data[indexed].get_key()] = indexed;
+    }
+
+    void clear()
     {
+        data.clear();
+        lookup.clear();
+        indexed = 0;
     }
-    virtual value::type_t get_type() override { return value::object_type; }
-    virtual std::vector<value>* if_array() override { return &data; }
-    virtual std::unordered_map<std::string, std::size_t>* if_object() override { return &lookup; }
+
+    // Returns the size when the key is not found
+    std::size_t index_of(const std::string& key) const
+    {
+        if(indexed == 0)
+        {
+            auto it = std::find_if(data.rbegin(), data.rend(), [&](const value& v) {
+                return v.get_key() == key;
+            });
+            return it == data.rend() ? data.size() : data.rend() - it - 1;
+        }
+        auto it = lookup.find(key);
+        if(it == lookup.end())
+            return data.size();
+        return it->second;
+    }
+
     std::vector<value> data;
     std::unordered_map<std::string, std::size_t> lookup;
+    std::size_t indexed = 0;
+    // Set once a mutable reference to an element has been handed out, after
+    // which copies of the value can no longer share this holder
+    bool leaked = false;
 };
 
-value::value(const value& rhs) : x(rhs.x ? rhs.x->clone() : nullptr), key(rhs.key) {}
-value& value::operator=(value rhs)
+template <class T>
+constexpr bool is_held_value()
 {
-    std::swap(rhs.x, x);
-    if(not rhs.key.empty())
-        std::swap(rhs.key, key);
-    return *this;
+    return std::is_same<T, std::string>{} or std::is_same<T, value::binary>{};
 }
 
-void set_vector(std::shared_ptr<value_base_impl>& x,
-                const std::vector<value>& v,
-                bool array_on_empty = true)
+template <class T, class Scalar>
+auto& scalar_member(Scalar& s)
 {
-    if(v.empty())
-    {
-        if(array_on_empty)
-            x = std::make_shared<array_value_holder>();
-        else
-            x = std::make_shared<object_value_holder>();
-        return;
-    }
-    if(v.front().get_key().empty())
+    if constexpr(std::is_same<T, std::int64_t>{})
+        return s.int64_value;
+    else if constexpr(std::is_same<T, std::uint64_t>{})
+        return s.uint64_value;
+    else if constexpr(std::is_same<T, double>{})
+        return s.float_value;
+    else
+        return s.bool_value;
+}
+
+template <class T>
+void value::set_data(type_t t, T d)
+{
+    vtype = t;
+    if constexpr(is_held_value<T>())
     {
-        x = std::make_shared<array_value_holder>(v);
+        x = std::make_shared<value_holder<T>>(std::move(d));
     }
     else
     {
-        std::unordered_map<std::string, std::size_t> lookup;
-        std::size_t i = 0;
-        for(auto&& e : v)
-        {
-            lookup[e.get_key()] = i;
-            i++;
-        }
-        x = std::make_shared<object_value_holder>(v, lookup);
+        x                        = nullptr;
+        scalar_member<T>(scalar) = d;
     }
 }
 
-value::value(const std::initializer_list<value>& i) : x(nullptr)
+template <class T>
+const T* value::if_data(type_t t) const
+{
+    if(vtype != t)
+        return nullptr;
+    if constexpr(is_held_value<T>())
+        return &static_cast<const value_holder<T>&>(*x).data;
+    else
+        return &scalar_member<T>(scalar);
+}
+
+void value::set_elements(std::vector<value> v, bool array_on_empty)
+{
+    bool object = v.empty() ? not array_on_empty : not v.front().get_key().empty();
+    vtype       = object ? object_type : array_type;
+    x           = std::make_shared<value_elements>(std::move(v), object);
+}
+
+void value::assign_data(const value& rhs)
+{
+    vtype                = rhs.vtype;
+    scalar               = rhs.scalar;
+    const auto* elements = rhs.get_elements();
+    if(elements != nullptr and elements->leaked)
+        x = std::make_shared<value_elements>(*elements);
+    else
+        x = rhs.x;
+}
+
+const value_elements* value::get_elements() const
+{
+    if(vtype != array_type and vtype != object_type)
+        return nullptr;
+    return static_cast<const value_elements*>(x.get());
+}
+
+value_elements& value::mutable_elements(bool leak)
+{
+    const auto* elements = get_elements();
+    if(elements == nullptr)
+        MIGRAPHX_THROW("Expected an array or object");
+    if(x.use_count() > 1)
+        x = std::make_shared<value_elements>(*elements);
+    auto* result   = static_cast<value_elements*>(x.get());
+    result->leaked = result->leaked or leak;
+    return *result;
+}
+
+value::value(const value& rhs) : key(rhs.key) { assign_data(rhs); }
+value::value(value&& rhs) noexcept
+    : vtype(rhs.vtype), scalar(rhs.scalar), x(std::move(rhs.x)), key(std::move(rhs.key))
+{
+    rhs.vtype = null_type;
+}
+value& value::operator=(value rhs)
+{
+    std::swap(rhs.vtype, vtype);
+    std::swap(rhs.scalar, scalar);
+    std::swap(rhs.x, x);
+    if(not rhs.key.empty())
+        std::swap(rhs.key, key);
+    return *this;
+}
+
+value::value(const std::initializer_list<value>& i)
 {
     if(i.size() == 2 and i.begin()->is_string() and i.begin()->get_key().empty())
     {
-        key    = i.begin()->get_string();
-        auto r = (i.begin() + 1)->x;
-        x      = r ? r->clone() : nullptr;
+        key = i.begin()->get_string();
+        assign_data(*(i.begin() + 1));
         return;
     }
-    set_vector(x, std::vector<value>(i.begin(), i.end()));
+    set_elements(std::vector<value>(i.begin(), i.end()), true);
 }
 
-value::value(const std::vector<value>& v, bool array_on_empty) : x(nullptr)
-{
-    set_vector(x, v, array_on_empty);
-}
+value::value(const std::vector<value>& v, bool array_on_empty) { set_elements(v, array_on_empty); }
 
 value::value(const std::unordered_map<std::string, value>& m)
     : value(std::vector<value>(m.begin(), m.end()), false)
@@ -144,9 +223,9 @@ value::value(const std::unordered_map<std::string, value>& m)
 }
 
 value::value(const std::string& pkey, const std::vector<value>& v, bool array_on_empty)
-    : x(nullptr), key(pkey)
+    : key(pkey)
 {
-    set_vector(x, v, array_on_empty);
+    set_elements(v, array_on_empty);
 }
 
 value::value(const std::string& pkey, const std::unordered_map<std::string, value>& m)
@@ -154,37 +233,34 @@ value::value(const std::string& pkey, const std::unordered_map<std::string, valu
 {
 }
 
-value::value(const std::string& pkey, std::nullptr_t) : x(nullptr), key(pkey) {}
+value::value(const std::string& pkey, std::nullptr_t) : key(pkey) {}
 
-value::value(std::nullptr_t) : x(nullptr) {}
+value::value(std::nullptr_t) {}
 
-value::value(const std::string& pkey, const value& rhs)
-    : x(rhs.x ? rhs.x->clone() : nullptr), key(pkey)
-{
-}
+value::value(const std::string& pkey, const value& rhs) : key(pkey) { assign_data(rhs); }
 
 value::value(const std::string& pkey, const char* i) : value(pkey, std::string(i)) {}
 value::value(const char* i) : value(std::string(i)) {}
 
-#define MIGRAPHX_VALUE_GENERATE_DEFINE_METHODS(vt, cpp_type)                           \
-    value::value(cpp_type i) : x(std::make_shared<vt##_value_holder>(std::move(i))) {} \
-    value::value(const std::string& pkey, cpp_type i)                                  \
-        : x(std::make_shared<vt##_value_holder>(std::move(i))), key(pkey)              \
-    {                                                                                  \
-    }                                                                                  \
-    value& value::operator=(cpp_type rhs)                                              \
-    {                                                                                  \
-        x = std::make_shared<vt##_value_holder>(std::move(rhs));                       \
-        return *this;                                                                  \
-    }                                                                                  \
-    bool value::is_##vt() const { return x ? x->get_type() == vt##_type : false; }     \
-    const cpp_type& value::get_##vt() const                                            \
-    {                                                                                  \
-        auto* r = this->if_##vt();                                                     \
-        assert(r);                                                                     \
-        return *r;                                                                     \
-    }                                                                                  \
-    const cpp_type* value::if_##vt() const { return x ? x->if_##vt() : nullptr; }
+#define MIGRAPHX_VALUE_GENERATE_DEFINE_METHODS(vt, cpp_type)                                \
+    value::value(cpp_type i) { set_data(vt##_type, std::move(i)); }                         \
+    value::value(const std::string& pkey, cpp_type i) : key(pkey)                           \
+    {                                                                                       \
+        set_data(vt##_type, std::move(i));                                                  \
+    }                                                                                       \
+    value& value::operator=(cpp_type rhs)                                                   \
+    {                                                                                       \
+        set_data(vt##_type, std::move(rhs));                                                \
+        return *this;                                                                       \
+    }                                                                                       \
+    bool value::is_##vt() const { return vtype == vt##_type; }                              \
+    const cpp_type& value::get_##vt() const                                                 \
+    {                                                                                       \
+        auto* r = this->if_##vt();                                                          \
+        assert(r);                                                                          \
+        return *r;                                                                          \
+    }                                                                                       \
+    const cpp_type* value::if_##vt() const { return this->if_data<cpp_type>(vt##_type); }
 MIGRAPHX_VISIT_VALUE_TYPES(MIGRAPHX_VALUE_GENERATE_DEFINE_METHODS)
 
 value& value::operator=(const char* c)
@@ -195,27 +271,34 @@ value& value::operator=(const char* c)
 
 value& value::operator=(std::nullptr_t)
 {
-    x = nullptr;
+    vtype = null_type;
+    x     = nullptr;
     return *this;
 }
 
 value& value::operator=(const std::initializer_list<value>& i)
 {
     value rhs = i;
+    std::swap(rhs.vtype, vtype);
+    std::swap(rhs.scalar, scalar);
     std::swap(rhs.x, x);
     return *this;
 }
 
-bool value::is_array() const { return x ? x->get_type() == array_type : false; }
+bool value::is_array() const { return vtype == array_type; }
 const std::vector<value>& value::value::get_array() const
 {
     const auto* r = this->if_array();
     assert(r);
     return *r;
 }
-const std::vector<value>* value::if_array() const { return x ? x->if_array() : nullptr; }
+const std::vector<value>* value::if_array() const
+{
+    const auto* elements = get_elements();
+    return elements ? &elements->data : nullptr;
+}
 
-bool value::is_object() const { return x ? x->get_type() == object_type : false; }
+bool value::is_object() const { return vtype == object_type; }
 const std::vector<value>& value::get_object() const
 {
     const auto* r = this->if_object();
@@ -224,56 +307,28 @@ const std::vector<value>& value::get_object() const
 }
 const std::vector<value>* value::if_object() const
 {
-    auto* r = x ? x->if_array() : nullptr;
+    const auto* r = this->if_array();
     assert(r == nullptr or
            std::none_of(r->begin(), r->end(), [](auto&& v) { return v.get_key().empty(); }));
     return r;
 }
 
-bool value::is_null() const { return x == nullptr; }
+bool value::is_null() const { return vtype == null_type; }
 
 const std::string& value::get_key() const { return key; }
 
-std::vector<value>* if_array_impl(const std::shared_ptr<value_base_impl>& x)
-{
-    if(x == nullptr)
-        return nullptr;
-    return x->if_array();
-}
-
-std::vector<value>& get_array_impl(const std::shared_ptr<value_base_impl>& x)
-{
-    auto* a = if_array_impl(x);
-    assert(a);
-    return *a;
-}
-
-std::vector<value>& get_array_throw(const std::shared_ptr<value_base_impl>& x)
+const value* value::find(const std::string& pkey) const
 {
-    auto* a = if_array_impl(x);
-    if(a == nullptr)
-        MIGRAPHX_THROW("Expected an array or object");
-    return *a;
+    if(not is_object())
+        return this->end();
+    const auto* elements = get_elements();
+    return elements->data.data() + elements->index_of(pkey);
 }
-
-template <class T>
-T* find_impl(const std::shared_ptr<value_base_impl>& x, const std::string& key, T* end)
+value* value::find(const std::string& pkey)
 {
-    auto* a = if_array_impl(x);
-    if(a == nullptr)
-        return end;
-    auto* lookup = x->if_object();
-    if(lookup == nullptr)
-        return end;
-    auto it = lookup->find(key);
-    if(it == lookup->end())
-        return end;
-    return std::addressof((*a)[it->second]);
+    auto i = std::as_const(*this).find(pkey) - std::as_const(*this).begin();
+    return this->begin() + i;
 }
-
-value* value::find(const std::string& pkey) { return find_impl(x, pkey, this->end()); }
-
-const value* value::find(const std::string& pkey) const { return find_impl(x, pkey, this->end()); }
 bool value::contains(const std::string& pkey) const
 {
     const auto* it = find(pkey);
@@ -285,25 +340,24 @@ bool value::contains(const std::string& pkey) const
 }
 std::size_t value::size() const
 {
-    const auto* a = if_array_impl(x);
-    if(a == nullptr)
+    const auto* elements = get_elements();
+    if(elements == nullptr)
         return 0;
-    return a->size();
+    return elements->data.size();
 }
 bool value::empty() const { return size() == 0; }
 const value* value::data() const
 {
-    auto* a = if_array_impl(x);
-    if(a == nullptr)
+    const auto* elements = get_elements();
+    if(elements == nullptr)
         return nullptr;
-    return a->data();
+    return elements->data.data();
 }
 value* value::data()
 {
-    auto* a = if_array_impl(x);
-    if(a == nullptr)
+    if(get_elements() == nullptr)
         return nullptr;
-    return a->data();
+    return mutable_elements(true).data.data();
 }
 value* value::begin()
 {
@@ -341,17 +395,16 @@ const value& value::back() const
 }
 value& value::at(std::size_t i)
 {
-    auto* a = if_array_impl(x);
-    if(a == nullptr)
+    if(get_elements() == nullptr)
         MIGRAPHX_THROW("Not an array");
-    return a->at(i);
+    return mutable_elements(true).data.at(i);
 }
 const value& value::at(std::size_t i) const
 {
-    auto* a = if_array_impl(x);
-    if(a == nullptr)
+    const auto* elements = get_elements();
+    if(elements == nullptr)
         MIGRAPHX_THROW("Not an array");
-    return a->at(i);
+    return elements->data.at(i);
 }
 value& value::at(const std::string& pkey)
 {
@@ -381,50 +434,62 @@ const value& value::operator[](std::size_t i) const
     assert(i < this->size());
     return *(begin() + i);
 }
-value& value::operator[](const std::string& pkey) { return *emplace(pkey, nullptr).first; }
+value& value::operator[](const std::string& pkey)
+{
+    auto* r = emplace(pkey, nullptr).first;
+    mutable_elements(true);
+    return *r;
+}
 
-void value::clear() { get_array_throw(x).clear(); }
+void value::clear() { mutable_elements(false).clear(); }
 void value::resize(std::size_t n)
 {
     if(not is_array())
         MIGRAPHX_THROW("Expected an array.");
-    get_array_impl(x).resize(n);
+    mutable_elements(false).data.resize(n);
 }
 void value::resize(std::size_t n, const value& v)
 {
     if(not is_array())
         MIGRAPHX_THROW("Expected an array.");
-    get_array_impl(x).resize(n, v);
+    mutable_elements(false).data.resize(n, v);
 }
 
 std::pair<value*, bool> value::insert(const value& v)
 {
     if(v.key.empty())
     {
-        if(not x)
-            x = std::make_shared<array_value_holder>();
-        get_array_impl(x).push_back(v);
+        if(is_null())
+            set_elements({}, true);
+        auto& elements = mutable_elements(false);
+        elements.data.push_back(v);
         assert(this->if_array());
-        return std::make_pair(&back(), true);
+        return std::make_pair(&elements.data.back(), true);
     }
     else
     {
-        if(not x)
-            x = std::make_shared<object_value_holder>();
-        auto p = x->if_object()->emplace(v.key, get_array_impl(x).size());
-        if(p.second)
-            get_array_impl(x).push_back(v);
+        if(is_null())
+            set_elements({}, false);
+        if(not is_object())
+            MIGRAPHX_THROW("Expected an object");
+        auto& elements = mutable_elements(false);
+        auto i         = elements.index_of(v.key);
+        if(i < elements.data.size())
+            return std::make_pair(&elements.data[i], false);
+        elements.data.push_back(v);
+        elements.update_lookup();
         assert(this->if_object());
-        return std::make_pair(&get_array_impl(x)[p.first->second], p.second);
+        return std::make_pair(&elements.data.back(), true);
     }
 }
 value* value::insert(const value* pos, const value& v)
 {
     assert(v.key.empty());
-    if(not x)
-        x = std::make_shared<array_value_holder>();
-    auto&& a = get_array_impl(x);
-    auto it  = a.insert(a.begin() + (pos - begin()), v);
+    auto i = pos - std::as_const(*this).begin();
+    if(is_null())
+        set_elements({}, true);
+    auto& elements = mutable_elements(false);
+    auto it        = elements.data.insert(elements.data.begin() + i, v);
     return std::addressof(*it);
 }
 
@@ -465,12 +530,7 @@ bool compare(const value& x, const value& y, F f)
     return result;
 }
 
-value::type_t value::get_type() const
-{
-    if(not x)
-        return null_type;
-    return x->get_type();
-}
+value::type_t value::get_type() const { return vtype; }
 
 bool operator==(const value& x, const value& y)
 {
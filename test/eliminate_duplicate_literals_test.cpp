@@ -0,0 +1,142 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/eliminate_duplicate_literals.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/program.hpp>
+
+#include <test.hpp>
+
+void run_pass(migraphx::program& p, bool intern = false)
+{
+    migraphx::run_passes(
+        p, {migraphx::eliminate_duplicate_literals{intern}, migraphx::dead_code_elimination{}});
+}
+
+std::vector<migraphx::instruction_ref> get_literals(const migraphx::module& m)
+{
+    std::vector<migraphx::instruction_ref> result;
+    for(auto ins : migraphx::iterator_for(m))
+    {
+        if(ins->name() == "@literal")
+            result.push_back(ins);
+    }
+    return result;
+}
+
+TEST_CASE(duplicate_literals)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    auto create_program = [&](bool duplicate) {
+        migraphx::program p;
+        auto* mm  = p.get_main_module();
+        auto x    = mm->add_parameter("x", s);
+        auto one1 = mm->add_literal(migraphx::literal{s, {1, 1, 1}});
+        auto one2 = duplicate ? mm->add_literal(migraphx::literal{s, {1, 1, 1}}) : one1;
+        auto add  = mm->add_instruction(migraphx::make_op("add"), x, one1);
+        auto mul  = mm->add_instruction(migraphx::make_op("mul"), add, one2);
+        mm->add_return({mul});
+        return p;
+    };
+    auto p1 = create_program(true);
+    run_pass(p1);
+    EXPECT(get_literals(*p1.get_main_module()).size() == 1);
+
+    auto p2 = create_program(false);
+    run_pass(p2);
+    EXPECT(p1.sort() == p2.sort());
+}
+
+TEST_CASE(different_literals)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", s);
+    auto l1  = mm->add_literal(migraphx::literal{s, {1, 1, 1}});
+    auto l2  = mm->add_literal(migraphx::literal{s, {1, 1, 2}});
+    auto l3  = mm->add_literal(migraphx::literal{{migraphx::shape::float_type, {3, 1}}, {1, 1, 1}});
+    auto add = mm->add_instruction(migraphx::make_op("add"), x, l1);
+    auto mul = mm->add_instruction(migraphx::make_op("mul"), add, l2);
+    mm->add_return({mul, l3});
+    run_pass(p);
+    EXPECT(get_literals(*mm).size() == 3);
+}
+
+TEST_CASE(share_literals_across_modules)
+{
+    migraphx::shape s{migraphx::shape::float_type, {5}};
+    std::vector<float> data = {1, 2, 3, 4, 5};
+    migraphx::program p;
+    auto* mm  = p.get_main_module();
+    auto cond = mm->add_parameter("cond", migraphx::shape{migraphx::shape::bool_type});
+    auto x    = mm->add_parameter("x", s);
+
+    auto* then_mod = p.create_module("If_0_if");
+    auto l1        = then_mod->add_literal(migraphx::literal(s, data));
+    then_mod->add_return({then_mod->add_instruction(migraphx::make_op("add"), x, l1)});
+
+    auto* else_mod = p.create_module("If_0_else");
+    auto l2        = else_mod->add_literal(migraphx::literal(s, data));
+    else_mod->add_return({else_mod->add_instruction(migraphx::make_op("mul"), x, l2)});
+
+    auto ret = mm->add_instruction(migraphx::make_op("if"), {cond}, {then_mod, else_mod});
+    mm->add_return({ret});
+    EXPECT(l1->get_literal().data() != l2->get_literal().data());
+    run_pass(p);
+
+    auto then_lits = get_literals(*then_mod);
+    auto else_lits = get_literals(*else_mod);
+    EXPECT(then_lits.size() == 1);
+    EXPECT(else_lits.size() == 1);
+    EXPECT(then_lits.front()->get_literal().data() == else_lits.front()->get_literal().data());
+}
+
+TEST_CASE(intern_literals_across_programs)
+{
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto create_program = [&] {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        auto x   = mm->add_parameter("x", s);
+        auto l   = mm->add_literal(migraphx::literal{s, {3, 1, 4, 1}});
+        mm->add_return({mm->add_instruction(migraphx::make_op("add"), x, l)});
+        return p;
+    };
+    auto p1 = create_program();
+    auto p2 = create_program();
+    run_pass(p1, true);
+    run_pass(p2, true);
+    auto l1 = get_literals(*p1.get_main_module());
+    auto l2 = get_literals(*p2.get_main_module());
+    EXPECT(l1.size() == 1);
+    EXPECT(l2.size() == 1);
+    EXPECT(l1.front()->get_literal().data() == l2.front()->get_literal().data());
+    EXPECT(p1 == p2);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,161 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/group_dots.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/make_op.hpp>
+
+#include <test.hpp>
+
+void run_pass(migraphx::module& m)
+{
+    migraphx::run_passes(m, {migraphx::group_dots{}, migraphx::dead_code_elimination{}});
+}
+
+TEST_CASE(group_independent_dots)
+{
+    migraphx::shape as{migraphx::shape::float_type, {4, 8}};
+    migraphx::shape bs{migraphx::shape::float_type, {8, 6}};
+    migraphx::module m1;
+    {
+        auto a1 = m1.add_parameter("a1", as);
+        auto b1 = m1.add_parameter("b1", bs);
+        auto a2 = m1.add_parameter("a2", as);
+        auto b2 = m1.add_parameter("b2", bs);
+        auto d1 = m1.add_instruction(migraphx::make_op("dot"), a1, b1);
+        auto r1 = m1.add_instruction(migraphx::make_op("relu"), d1);
+        auto d2 = m1.add_instruction(migraphx::make_op("dot"), a2, b2);
+        auto r2 = m1.add_instruction(migraphx::make_op("relu"), d2);
+        m1.add_return({r1, r2});
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto a1  = m2.add_parameter("a1", as);
+        auto b1  = m2.add_parameter("b1", bs);
+        auto a2  = m2.add_parameter("a2", as);
+        auto b2  = m2.add_parameter("b2", bs);
+        auto ua1 = m2.add_instruction(migraphx::make_op("unsqueeze", {{"axes", {0}}}), a1);
+        auto ub1 = m2.add_instruction(migraphx::make_op("unsqueeze", {{"axes", {0}}}), b1);
+        auto ua2 = m2.add_instruction(migraphx::make_op("unsqueeze", {{"axes", {0}}}), a2);
+        auto ub2 = m2.add_instruction(migraphx::make_op("unsqueeze", {{"axes", {0}}}), b2);
+        auto a   = m2.add_instruction(migraphx::make_op("concat", {{"axis", 0}}), ua1, ua2);
+        auto b   = m2.add_instruction(migraphx::make_op("concat", {{"axis", 0}}), ub1, ub2);
+        auto d   = m2.add_instruction(migraphx::make_op("dot"), a, b);
+        auto s1  = m2.add_instruction(
+            migraphx::make_op("slice", {{"axes", {0}}, {"starts", {0}}, {"ends", {1}}}), d);
+        auto q1 = m2.add_instruction(migraphx::make_op("squeeze", {{"axes", {0}}}), s1);
+        auto s2 = m2.add_instruction(
+            migraphx::make_op("slice", {{"axes", {0}}, {"starts", {1}}, {"ends", {2}}}), d);
+        auto q2 = m2.add_instruction(migraphx::make_op("squeeze", {{"axes", {0}}}), s2);
+        auto r1 = m2.add_instruction(migraphx::make_op("relu"), q1);
+        auto r2 = m2.add_instruction(migraphx::make_op("relu"), q2);
+        m2.add_return({r1, r2});
+    }
+    EXPECT(m1 == m2);
+}
+
+TEST_CASE(group_dependent_dots)
+{
+    migraphx::shape s{migraphx::shape::float_type, {4, 4}};
+    migraphx::module m1;
+    {
+        auto a  = m1.add_parameter("a", s);
+        auto b1 = m1.add_parameter("b1", s);
+        auto b2 = m1.add_parameter("b2", s);
+        auto d1 = m1.add_instruction(migraphx::make_op("dot"), a, b1);
+        auto r1 = m1.add_instruction(migraphx::make_op("relu"), d1);
+        auto d2 = m1.add_instruction(migraphx::make_op("dot"), r1, b2);
+        m1.add_return({d2});
+    }
+    migraphx::module m2 = m1;
+    run_pass(m1);
+    EXPECT(m1 == m2);
+}
+
+TEST_CASE(group_different_shapes)
+{
+    migraphx::module m1;
+    {
+        auto a1 = m1.add_parameter("a1", {migraphx::shape::float_type, {4, 8}});
+        auto b1 = m1.add_parameter("b1", {migraphx::shape::float_type, {8, 6}});
+        auto a2 = m1.add_parameter("a2", {migraphx::shape::float_type, {4, 8}});
+        auto b2 = m1.add_parameter("b2", {migraphx::shape::float_type, {8, 5}});
+        auto d1 = m1.add_instruction(migraphx::make_op("dot"), a1, b1);
+        auto d2 = m1.add_instruction(migraphx::make_op("dot"), a2, b2);
+        m1.add_return({d1, d2});
+    }
+    migraphx::module m2 = m1;
+    run_pass(m1);
+    EXPECT(m1 == m2);
+}
+
+TEST_CASE(group_large_dots)
+{
+    migraphx::shape s{migraphx::shape::float_type, {128, 128}};
+    migraphx::module m1;
+    {
+        auto a1 = m1.add_parameter("a1", s);
+        auto b1 = m1.add_parameter("b1", s);
+        auto a2 = m1.add_parameter("a2", s);
+        auto b2 = m1.add_parameter("b2", s);
+        auto d1 = m1.add_instruction(migraphx::make_op("dot"), a1, b1);
+        auto d2 = m1.add_instruction(migraphx::make_op("dot"), a2, b2);
+        m1.add_return({d1, d2});
+    }
+    migraphx::module m2 = m1;
+    run_pass(m1);
+    EXPECT(m1 == m2);
+}
+
+TEST_CASE(group_moves_inputs)
+{
+    migraphx::shape s{migraphx::shape::float_type, {4, 4}};
+    migraphx::module m1;
+    {
+        auto a1 = m1.add_parameter("a1", s);
+        auto a2 = m1.add_parameter("a2", s);
+        auto b  = m1.add_parameter("b", s);
+        auto d1 = m1.add_instruction(migraphx::make_op("dot"), a1, b);
+        auto r1 = m1.add_instruction(migraphx::make_op("relu"), d1);
+        auto t  = m1.add_instruction(migraphx::make_op("tanh"), a2);
+        auto d2 = m1.add_instruction(migraphx::make_op("dot"), t, b);
+        auto r2 = m1.add_instruction(migraphx::make_op("relu"), d2);
+        m1.add_return({r1, r2});
+    }
+    run_pass(m1);
+    EXPECT(std::count_if(m1.begin(), m1.end(), [](const auto& ins) {
+               return ins.name() == "dot";
+           }) == 1);
+    auto dot = std::find_if(m1.begin(), m1.end(), [](const auto& ins) {
+        return ins.name() == "dot";
+    });
+    EXPECT(dot->get_shape().lens() == std::vector<std::size_t>{2, 4, 4});
+    EXPECT(bool{m1.validate() == m1.end()});
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
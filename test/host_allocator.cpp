@@ -0,0 +1,124 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/host_allocator.hpp>
+#include <migraphx/make_shared_array.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/literal.hpp>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include "test.hpp"
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_HOST_HUGE_PAGES)
+
+static bool is_aligned(const void* ptr, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0; // NOLINT
+}
+
+TEST_CASE(host_buffer_aligned)
+{
+    for(std::size_t n : {0, 1, 63, 64, 1000})
+    {
+        auto buffer = migraphx::allocate_host_buffer(n);
+        EXPECT(buffer != nullptr);
+        EXPECT(is_aligned(buffer.get(), migraphx::host_buffer_alignment));
+        EXPECT(std::all_of(buffer.get(), buffer.get() + n, [](char c) { return c == 0; }));
+    }
+}
+
+TEST_CASE(host_buffer_huge_page)
+{
+    auto n      = migraphx::host_huge_page_size + 1;
+    auto before = migraphx::get_host_allocation_stats();
+    {
+        auto buffer = migraphx::allocate_host_buffer(n);
+        if(not migraphx::enabled(MIGRAPHX_DISABLE_HOST_HUGE_PAGES{}))
+            EXPECT(is_aligned(buffer.get(), migraphx::host_huge_page_size));
+        EXPECT(std::all_of(buffer.get(), buffer.get() + n, [](char c) { return c == 0; }));
+        // Only buffers the kernel accepted the advice for are counted
+        auto huge_bytes = migraphx::get_host_allocation_stats().huge_page_bytes;
+        EXPECT(huge_bytes == before.huge_page_bytes or
+               huge_bytes == before.huge_page_bytes + 2 * migraphx::host_huge_page_size);
+    }
+    EXPECT(migraphx::get_host_allocation_stats().huge_page_bytes == before.huge_page_bytes);
+}
+
+TEST_CASE(host_buffer_stats)
+{
+    auto before = migraphx::get_host_allocation_stats();
+    {
+        auto buffer = migraphx::allocate_host_buffer(1000);
+        auto during = migraphx::get_host_allocation_stats();
+        EXPECT(during.bytes >= before.bytes + 1000);
+        EXPECT(during.peak_bytes >= during.bytes);
+        EXPECT(during.allocations == before.allocations + 1);
+    }
+    auto after = migraphx::get_host_allocation_stats();
+    EXPECT(after.bytes == before.bytes);
+    migraphx::reset_host_allocation_peak();
+    EXPECT(migraphx::get_host_allocation_stats().peak_bytes ==
+           migraphx::get_host_allocation_stats().bytes);
+}
+
+TEST_CASE(host_buffer_typed_array)
+{
+    auto a = migraphx::make_shared_array<float>(17);
+    EXPECT(is_aligned(a.get(), migraphx::host_buffer_alignment));
+    EXPECT(std::all_of(a.get(), a.get() + 17, [](float x) { return x == 0; }));
+
+    migraphx::shape s{migraphx::shape::float_type, {4, 5}};
+    migraphx::argument arg{s};
+    EXPECT(is_aligned(arg.data(), migraphx::host_buffer_alignment));
+    migraphx::literal lit{s, std::vector<float>(20, 1.0f)};
+    EXPECT(is_aligned(lit.data(), migraphx::host_buffer_alignment));
+}
+
+TEST_CASE(custom_host_allocator)
+{
+    std::size_t allocated   = 0;
+    std::size_t deallocated = 0;
+    migraphx::host_allocator a;
+    a.allocate = [&](std::size_t bytes, std::size_t alignment) {
+        allocated += bytes;
+        return static_cast<char*>(::operator new(bytes, std::align_val_t{alignment}));
+    };
+    a.deallocate = [&](char* ptr, std::size_t bytes, std::size_t alignment) {
+        deallocated += bytes;
+        ::operator delete(ptr, std::align_val_t{alignment});
+    };
+    migraphx::set_host_allocator(a);
+    auto buffer = migraphx::allocate_host_buffer(100);
+    migraphx::set_host_allocator({});
+    EXPECT(allocated >= 100);
+    EXPECT(deallocated == 0);
+    buffer = nullptr;
+    EXPECT(deallocated == allocated);
+    auto other = migraphx::allocate_host_buffer(100);
+    EXPECT(other != nullptr);
+    EXPECT(allocated == deallocated);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
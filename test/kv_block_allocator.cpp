@@ -0,0 +1,95 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/kv_block_allocator.hpp>
+#include <test.hpp>
+
+TEST_CASE(allocate_blocks)
+{
+    migraphx::kv_block_allocator a{4, 2};
+    EXPECT(a.free_blocks() == 4);
+    EXPECT(a.append(0, 3));
+    EXPECT(a.sequence_length(0) == 3);
+    EXPECT(a.blocks(0) == std::vector<std::int32_t>{0, 1});
+    EXPECT(a.free_blocks() == 2);
+    // The second block still has room for one token
+    EXPECT(a.append(0));
+    EXPECT(a.free_blocks() == 2);
+    EXPECT(a.append(1));
+    EXPECT(a.blocks(1) == std::vector<std::int32_t>{2});
+    EXPECT(a.free_blocks() == 1);
+}
+
+TEST_CASE(allocate_out_of_blocks)
+{
+    migraphx::kv_block_allocator a{2, 4};
+    EXPECT(a.append(0, 5));
+    EXPECT(not a.append(1, 5));
+    EXPECT(not a.contains(1));
+    EXPECT(not a.append(0, 4));
+    EXPECT(a.sequence_length(0) == 5);
+    EXPECT(a.free_blocks() == 0);
+}
+
+TEST_CASE(append_zero_tokens)
+{
+    migraphx::kv_block_allocator a{2, 4};
+    EXPECT(test::throws([&] { a.append(0, 0); }));
+    EXPECT(not a.contains(0));
+    EXPECT(a.append(0, 2));
+    EXPECT(test::throws([&] { a.append(0, 0); }));
+    EXPECT(a.sequence_length(0) == 2);
+}
+
+TEST_CASE(release_blocks)
+{
+    migraphx::kv_block_allocator a{3, 1};
+    EXPECT(a.append(0, 2));
+    EXPECT(a.append(1, 1));
+    a.release(0);
+    EXPECT(not a.contains(0));
+    EXPECT(a.free_blocks() == 2);
+    EXPECT(a.append(2, 2));
+    EXPECT(a.blocks(2) == std::vector<std::int32_t>{0, 1});
+    EXPECT(test::throws([&] { a.blocks(0); }));
+}
+
+TEST_CASE(block_table)
+{
+    migraphx::kv_block_allocator a{4, 2};
+    EXPECT(a.append(0, 1));
+    EXPECT(a.append(1, 3));
+    auto table = a.make_block_table({1, 0}, 3);
+    EXPECT(table.get_shape() == migraphx::shape{migraphx::shape::int32_type, {2, 3}});
+    std::vector<std::int32_t> table_data;
+    table.visit([&](auto v) { table_data.assign(v.begin(), v.end()); });
+    EXPECT(table_data == std::vector<std::int32_t>{1, 2, -1, 0, -1, -1});
+
+    auto seqlens = a.make_seqlens_k({1, 0});
+    std::vector<std::int32_t> seqlens_data;
+    seqlens.visit([&](auto v) { seqlens_data.assign(v.begin(), v.end()); });
+    EXPECT(seqlens_data == std::vector<std::int32_t>{2, 0});
+    EXPECT(test::throws([&] { a.make_block_table({1}, 1); }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
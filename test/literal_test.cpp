@@ -183,4 +183,58 @@ TEST_CASE(literal_to_string_float_precision)
     EXPECT(x.to_string() != "127");
 }
 
+TEST_CASE(literal_hash)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    migraphx::literal l1{s, {1, 2, 3}};
+    migraphx::literal l2{s, {1, 2, 3}};
+    migraphx::literal l3{s, {3, 2, 1}};
+    migraphx::literal l4{migraphx::shape{migraphx::shape::float_type, {3, 1}}, {1, 2, 3}};
+    EXPECT(hash_value(l1) == hash_value(l2));
+    EXPECT(hash_value(l1) != hash_value(l3));
+    EXPECT(hash_value(l1) != hash_value(l4));
+}
+
+TEST_CASE(literal_equal_cached_hash)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    migraphx::literal l1{s, {1, 2, 3}};
+    migraphx::literal l2{s, {1, 2, 3}};
+    migraphx::literal l3{s, {3, 2, 1}};
+    auto h1 = hash_value(l1);
+    hash_value(l3);
+    // NOLINTNEXTLINE(performance-unnecessary-copy-initialization)
+    migraphx::literal l4 = l1;
+    EXPECT(hash_value(l4) == h1);
+    EXPECT(l1 == l4);
+    EXPECT(l1 == l2);
+    EXPECT(l1 != l3);
+}
+
+TEST_CASE(literal_equal_signed_zero)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2}};
+    migraphx::literal l1{s, {0.0f, 1.0f}};
+    migraphx::literal l2{s, {-0.0f, 1.0f}};
+    EXPECT(l1 == l2);
+    EXPECT(hash_value(l1) == hash_value(l2));
+    EXPECT(l1 == l2);
+}
+
+TEST_CASE(literal_intern)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    migraphx::literal l1{s, {7, 8, 9}};
+    migraphx::literal l2{s, {7, 8, 9}};
+    migraphx::literal l3{s, {9, 8, 7}};
+    auto i1 = migraphx::intern_literal(l1);
+    auto i2 = migraphx::intern_literal(l2);
+    auto i3 = migraphx::intern_literal(l3);
+    EXPECT(i1.data() == l1.data());
+    EXPECT(i2.data() == l1.data());
+    EXPECT(i2 == l2);
+    EXPECT(i3.data() == l3.data());
+    EXPECT(migraphx::intern_literal(migraphx::literal{}).empty());
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -22,6 +22,7 @@
  * THE SOFTWARE.
  */
 #include <migraphx/module.hpp>
+#include <migraphx/dom_info.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/pass_manager.hpp>
@@ -98,6 +99,7 @@ TEST_CASE(calc_implict_deps)
     EXPECT(migraphx::contains(implicit_deps.at(ret), y2));
     EXPECT(migraphx::contains(implicit_deps.at(ret), lx));
     EXPECT(migraphx::contains(implicit_deps.at(ret), ly));
+    EXPECT(bool{mm->get_implicit_deps() == implicit_deps});
     // test for sorting
     p.sort();
     auto ret_inputs = ret->inputs();
@@ -135,6 +137,72 @@ TEST_CASE(module_ins_clear)
     EXPECT(p1 == p2);
 }
 
+static bool order_matches_positions(const migraphx::module& m)
+{
+    std::size_t i = 0;
+    for(auto x : migraphx::iterator_for(m))
+    {
+        if(m.get_index(x) != i)
+            return false;
+        std::size_t j = 0;
+        for(auto y : migraphx::iterator_for(m))
+        {
+            if(m.precedes(x, y) != (i < j))
+                return false;
+            j++;
+        }
+        i++;
+    }
+    return true;
+}
+
+TEST_CASE(module_index_order)
+{
+    migraphx::module m;
+    auto x   = m.add_parameter("x", {migraphx::shape::int64_type});
+    auto sum = m.add_instruction(sum_op{}, x, x);
+    m.add_return({sum});
+    EXPECT(order_matches_positions(m));
+
+    // Enough insertions at the same place to run out of room between labels
+    for(int i = 0; i < 100; i++)
+        m.insert_literal(sum, i);
+    for(int i = 0; i < 100; i++)
+        m.add_literal(i);
+    EXPECT(order_matches_positions(m));
+
+    m.move_instruction(sum, m.begin());
+    m.move_instruction(sum, std::prev(m.end()));
+    EXPECT(order_matches_positions(m));
+    EXPECT(m.get_index(sum) == m.size() - 2);
+
+    m.remove_instruction(std::next(m.begin()));
+    EXPECT(order_matches_positions(m));
+}
+
+TEST_CASE(module_cached_analysis)
+{
+    migraphx::module m;
+    auto x = m.add_parameter("x", {migraphx::shape::float_type});
+    auto a = m.add_instruction(pass_op{}, x);
+    auto b = m.add_instruction(pass_op{}, a);
+    auto c = m.add_instruction(pass_op{}, x);
+    EXPECT(m.get_dominator_info().strictly_dominate(a, b));
+
+    auto generation = migraphx::instruction::get_generation();
+    EXPECT(m.get_dominator_info().strictly_dominate(a, b));
+    EXPECT(migraphx::instruction::get_generation() == generation);
+
+    m.replace_instruction(b, pass_op{}, c);
+    EXPECT(not m.get_dominator_info().strictly_dominate(a, b));
+    EXPECT(m.get_dominator_info().strictly_dominate(c, b));
+
+    // Changes made directly to an instruction also invalidate the analyses
+    migraphx::instruction::replace_argument(b, c, a);
+    EXPECT(m.get_dominator_info().strictly_dominate(a, b));
+    EXPECT(not m.get_dominator_info().strictly_dominate(c, b));
+}
+
 TEST_CASE(module_name)
 {
     migraphx::module m1("name");
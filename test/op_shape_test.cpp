@@ -4831,6 +4831,17 @@ TEST_CASE(test_squeeze_wrong_axis)
     throws_shape(migraphx::make_op("squeeze", {{"axes", {0}}}), s1);
 }
 
+TEST_CASE(test_topk)
+{
+    migraphx::shape input{migraphx::shape::float_type, {3, 5}};
+    expect_shape(migraphx::shape{{{migraphx::shape::float_type, {3, 2}},
+                                  {migraphx::shape::int64_type, {3, 2}}}},
+                 migraphx::make_op("topk", {{"k", 2}, {"axis", 1}}),
+                 input);
+    throws_shape(migraphx::make_op("topk", {{"k", 0}, {"axis", 1}}), input);
+    throws_shape(migraphx::make_op("topk", {{"k", 6}, {"axis", 1}}), input);
+}
+
 TEST_CASE(test_unique_axis_invalid)
 {
     migraphx::shape x_shape{migraphx::shape::float_type, {10, 4, 3}};
@@ -130,6 +130,20 @@ TEST_CASE(operation_equal_test)
     EXPECT(op3 != op1);
 }
 
+TEST_CASE(operation_hash_test)
+{
+    simple_operation s{};
+    migraphx::operation op1 = s;
+    migraphx::operation op2 = s;
+    s.data                  = 2;
+    migraphx::operation op3 = s;
+
+    EXPECT(op1.hash() == op2.hash());
+    EXPECT(op1.hash() != op3.hash());
+    EXPECT(migraphx::operation{simple_operation_no_print{}}.hash() ==
+           migraphx::operation{simple_operation_no_print{}}.hash());
+}
+
 struct not_operation
 {
 };
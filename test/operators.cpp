@@ -90,6 +90,17 @@ TEST_CASE(make_rnn_op_from_value)
     EXPECT(x == y);
 }
 
+TEST_CASE(make_op_hash)
+{
+    migraphx::operation x = migraphx::make_op("convolution", {{"padding", {1, 1}}});
+    migraphx::operation y = migraphx::make_op("convolution", {{"padding", {1, 1}}});
+    migraphx::operation z = migraphx::make_op("convolution", {{"padding", {2, 2}}});
+    EXPECT(x.hash() == y.hash());
+    EXPECT(x.hash() != z.hash());
+    EXPECT(migraphx::any_cast<migraphx::op::convolution>(z).padding ==
+           std::vector<std::size_t>{2, 2});
+}
+
 TEST_CASE(make_op_invalid_key)
 {
     EXPECT(test::throws([] { migraphx::make_op("convolution", {{"paddings", {1, 1}}}); }));
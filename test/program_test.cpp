@@ -25,6 +25,7 @@
 #include <migraphx/program.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/instruction.hpp>
+#include <migraphx/ranges.hpp>
 #include <migraphx/register_target.hpp>
 #include <sstream>
 #include <migraphx/apply_alpha_beta.hpp>
@@ -196,4 +197,36 @@ TEST_CASE(program_copy)
     }
 }
 
+TEST_CASE(program_memory_usage)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {4, 4}};
+    auto x   = mm->add_parameter("x", s);
+    auto l1  = mm->add_literal(migraphx::literal{s, std::vector<float>(16, 1)});
+    auto l2  = mm->add_literal(l1->get_literal());
+    auto add = mm->add_instruction(migraphx::make_op("add"), x, l1);
+    auto mul = mm->add_instruction(migraphx::make_op("mul"), add, l2);
+    auto r   = mm->add_instruction(migraphx::make_op("relu"), mul);
+    mm->add_return({r});
+
+    auto usage = p.get_memory_usage();
+    EXPECT(usage.modules.size() == 1);
+    const auto& mu = usage.modules.front();
+    EXPECT(mu.name == "main");
+    EXPECT(mu.literal_bytes == 128);
+    EXPECT(usage.literal_bytes == 64);
+    EXPECT(mu.parameter_bytes == 64);
+    EXPECT(mu.scratch_bytes == 0);
+    EXPECT(mu.peak_live_bytes == 128);
+    EXPECT(mu.peak_live_instructions.size() == 2);
+    EXPECT(migraphx::contains(mu.peak_live_instructions, add));
+    EXPECT(migraphx::contains(mu.peak_live_instructions, mul));
+    EXPECT(usage.total_bytes() == 256);
+
+    std::stringstream ss;
+    p.memory_report(ss);
+    EXPECT(ss.str().find("Total: 256 bytes") != std::string::npos);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -25,6 +25,7 @@
 #include <migraphx/dead_code_elimination.hpp>
 #include <migraphx/pass_manager.hpp>
 #include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
 #include <migraphx/make_op.hpp>
 #include <basic_ops.hpp>
 
@@ -51,6 +52,86 @@ TEST_CASE(const_add)
     EXPECT(m1 == m2);
 }
 
+TEST_CASE(const_add_memory_budget)
+{
+    auto create_module = [] {
+        migraphx::module m;
+        migraphx::shape s{migraphx::shape::float_type, {3}};
+        auto x = m.add_literal(migraphx::literal{s, {1, 2, 3}});
+        auto y = m.add_literal(migraphx::literal{s, {4, 5, 6}});
+        auto xb =
+            m.add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", {1000, 3}}}), x);
+        auto yb =
+            m.add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", {1000, 3}}}), y);
+        auto sum = m.add_instruction(migraphx::make_op("add"), xb, yb);
+        m.add_instruction(non_const_pass_op{}, sum);
+        return m;
+    };
+    auto m1 = create_module();
+    migraphx::run_passes(
+        m1, {migraphx::propagate_constant{{}, 1000}, migraphx::dead_code_elimination{}});
+    EXPECT(m1 == create_module());
+
+    auto m2 = create_module();
+    migraphx::run_passes(
+        m2, {migraphx::propagate_constant{{}, 100000}, migraphx::dead_code_elimination{}});
+    EXPECT(m2 != create_module());
+    EXPECT(std::count_if(m2.begin(), m2.end(), [](const auto& ins) {
+               return ins.name() == "@literal";
+           }) == 1);
+}
+
+TEST_CASE(const_memory_budget_shared_literal)
+{
+    // Both folds read w, so w is only freed when both are folded
+    auto create_module = [] {
+        migraphx::module m;
+        migraphx::shape s{migraphx::shape::float_type, {1000}};
+        auto w   = m.add_literal(migraphx::literal{s, std::vector<float>(1000, 1)});
+        auto neg = m.add_instruction(migraphx::make_op("neg"), w);
+        auto abs = m.add_instruction(migraphx::make_op("abs"), w);
+        auto p1  = m.add_instruction(non_const_pass_op{}, neg);
+        auto p2  = m.add_instruction(non_const_pass_op{}, abs);
+        m.add_return({p1, p2});
+        return m;
+    };
+    auto m1 = create_module();
+    migraphx::run_passes(
+        m1, {migraphx::propagate_constant{{}, 6000}, migraphx::dead_code_elimination{}});
+    EXPECT(m1 == create_module());
+
+    auto m2 = create_module();
+    migraphx::run_passes(
+        m2, {migraphx::propagate_constant{{}, 8000}, migraphx::dead_code_elimination{}});
+    EXPECT(std::count_if(m2.begin(), m2.end(), [](const auto& ins) {
+               return ins.name() == "@literal";
+           }) == 2);
+}
+
+TEST_CASE(const_memory_budget_literal_used_elsewhere)
+{
+    // w is still used after the fold, so folding adds a new literal
+    auto create_module = [] {
+        migraphx::module m;
+        migraphx::shape s{migraphx::shape::float_type, {1000}};
+        auto w   = m.add_literal(migraphx::literal{s, std::vector<float>(1000, 1)});
+        auto neg = m.add_instruction(migraphx::make_op("neg"), w);
+        auto p1  = m.add_instruction(non_const_pass_op{}, neg);
+        auto p2  = m.add_instruction(non_const_pass_op{}, w);
+        m.add_return({p1, p2});
+        return m;
+    };
+    auto m1 = create_module();
+    migraphx::run_passes(
+        m1, {migraphx::propagate_constant{{}, 6000}, migraphx::dead_code_elimination{}});
+    EXPECT(m1 == create_module());
+
+    auto m2 = create_module();
+    migraphx::run_passes(
+        m2, {migraphx::propagate_constant{{}, 8000}, migraphx::dead_code_elimination{}});
+    EXPECT(m2 != create_module());
+}
+
 TEST_CASE(const_add_parameter)
 {
     migraphx::module m1;
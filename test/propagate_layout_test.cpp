@@ -0,0 +1,146 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/propagate_layout.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/make_op.hpp>
+
+#include <test.hpp>
+
+void run_pass(migraphx::module& m)
+{
+    migraphx::run_passes(m, {migraphx::propagate_layout{}, migraphx::dead_code_elimination{}});
+}
+
+TEST_CASE(transpose_reduce)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4, 5}};
+    migraphx::module m1;
+    {
+        auto x = m1.add_parameter("x", s);
+        auto t =
+            m1.add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 2, 3, 1}}}), x);
+        auto r = m1.add_instruction(migraphx::make_op("reduce_sum", {{"axes", {1, 2}}}), t);
+        m1.add_return({r});
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto x = m2.add_parameter("x", s);
+        auto r = m2.add_instruction(migraphx::make_op("reduce_sum", {{"axes", {2, 3}}}), x);
+        auto t =
+            m2.add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 2, 3, 1}}}), r);
+        m2.add_return({t});
+    }
+    EXPECT(m1 == m2);
+}
+
+TEST_CASE(transpose_pointwise_inverse)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4, 5}};
+    migraphx::module m1;
+    {
+        auto x = m1.add_parameter("x", s);
+        auto y = m1.add_parameter("y", {migraphx::shape::float_type, {3}});
+        auto t =
+            m1.add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 2, 3, 1}}}), x);
+        auto b = m1.add_instruction(
+            migraphx::make_op("multibroadcast", {{"out_lens", t->get_shape().lens()}}), y);
+        auto relu = m1.add_instruction(migraphx::make_op("relu"), t);
+        auto add  = m1.add_instruction(migraphx::make_op("add"), relu, b);
+        auto t2 =
+            m1.add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 3, 1, 2}}}), add);
+        m1.add_return({t2});
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto x = m2.add_parameter("x", s);
+        auto y = m2.add_parameter("y", {migraphx::shape::float_type, {3}});
+        auto b = m2.add_instruction(
+            migraphx::make_op("multibroadcast", {{"out_lens", {2, 4, 5, 3}}}), y);
+        auto relu = m2.add_instruction(migraphx::make_op("relu"), x);
+        auto bt =
+            m2.add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 3, 1, 2}}}), b);
+        auto add = m2.add_instruction(migraphx::make_op("add"), relu, bt);
+        auto t =
+            m2.add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 2, 3, 1}}}), add);
+        auto t2 =
+            m2.add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 3, 1, 2}}}), t);
+        m2.add_return({t2});
+    }
+    EXPECT(m1 == m2);
+}
+
+TEST_CASE(transpose_pointwise_standard_output)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4, 5}};
+    migraphx::module m1;
+    {
+        auto x = m1.add_parameter("x", s);
+        auto t =
+            m1.add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 2, 3, 1}}}), x);
+        auto relu = m1.add_instruction(migraphx::make_op("relu"), t);
+        m1.add_return({relu});
+    }
+    migraphx::module m2 = m1;
+    run_pass(m1);
+    EXPECT(m1 == m2);
+}
+
+TEST_CASE(transpose_pointwise_multiple_transposes)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4, 5}};
+    migraphx::module m1;
+    {
+        auto x  = m1.add_parameter("x", s);
+        auto y  = m1.add_parameter("y", s);
+        auto tx =
+            m1.add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 2, 3, 1}}}), x);
+        auto ty =
+            m1.add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 2, 3, 1}}}), y);
+        auto add = m1.add_instruction(migraphx::make_op("add"), tx, ty);
+        auto r   = m1.add_instruction(migraphx::make_op("reduce_max", {{"axes", {3}}}), add);
+        m1.add_return({r});
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto x   = m2.add_parameter("x", s);
+        auto y   = m2.add_parameter("y", s);
+        auto add = m2.add_instruction(migraphx::make_op("add"), x, y);
+        auto r   = m2.add_instruction(migraphx::make_op("reduce_max", {{"axes", {1}}}), add);
+        auto t =
+            m2.add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 2, 3, 1}}}), r);
+        m2.add_return({t});
+    }
+    EXPECT(m1 == m2);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
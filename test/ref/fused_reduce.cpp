@@ -0,0 +1,137 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/fuse_pointwise.hpp>
+#include <migraphx/fuse_reduce.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/literal.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/verify.hpp>
+
+#include <test.hpp>
+
+static std::vector<float> eval_fused(migraphx::program p, const migraphx::parameter_map& params)
+{
+    migraphx::run_passes(p,
+                         {migraphx::fuse_pointwise{.enable_rewrite_reshapes = false},
+                          migraphx::fuse_reduce{.enable_rewrite_reshapes = false},
+                          migraphx::dead_code_elimination{}});
+    auto* mm = p.get_main_module();
+    EXPECT(std::any_of(
+        mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "fused_reduce"; }));
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval(params).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    return results_vector;
+}
+
+static std::vector<float> eval_unfused(migraphx::program p, const migraphx::parameter_map& params)
+{
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval(params).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    return results_vector;
+}
+
+TEST_CASE(fused_reduce_rms_norm)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 8}};
+    migraphx::shape gs{migraphx::shape::float_type, {8}};
+    migraphx::program p;
+    auto* mm  = p.get_main_module();
+    auto x    = mm->add_parameter("x", s);
+    auto g    = mm->add_parameter("g", gs);
+    auto sq   = mm->add_instruction(migraphx::make_op("mul"), x, x);
+    auto mean = mm->add_instruction(migraphx::make_op("reduce_mean", {{"axes", {2}}}), sq);
+    auto eps  = mm->add_literal(migraphx::literal{migraphx::shape{s.type()}, {1e-5f}});
+    auto epsb =
+        mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", {2, 3, 1}}}), eps);
+    auto add = mm->add_instruction(migraphx::make_op("add"), mean, epsb);
+    auto rs  = mm->add_instruction(migraphx::make_op("rsqrt"), add);
+    auto rsb =
+        mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", s.lens()}}), rs);
+    auto y  = mm->add_instruction(migraphx::make_op("mul"), x, rsb);
+    auto gb = mm->add_instruction(
+        migraphx::make_op("broadcast", {{"axis", 2}, {"out_lens", s.lens()}}), g);
+    mm->add_instruction(migraphx::make_op("mul"), y, gb);
+
+    std::vector<float> x_data(s.elements());
+    std::vector<float> g_data(gs.elements());
+    std::iota(x_data.begin(), x_data.end(), -20.0f);
+    std::iota(g_data.begin(), g_data.end(), 0.5f);
+    migraphx::parameter_map params;
+    params["x"] = migraphx::argument(s, x_data.data());
+    params["g"] = migraphx::argument(gs, g_data.data());
+
+    auto gold = eval_unfused(p, params);
+    EXPECT(migraphx::verify::verify_rms_range(eval_fused(p, params), gold));
+}
+
+TEST_CASE(fused_reduce_transposed_sum)
+{
+    migraphx::shape s{migraphx::shape::float_type, {4, 3, 5}};
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", s);
+    auto t   = mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {2, 0, 1}}}), x);
+    auto e   = mm->add_instruction(migraphx::make_op("exp"), t);
+    auto sum = mm->add_instruction(migraphx::make_op("reduce_sum", {{"axes", {0, 2}}}), e);
+    mm->add_instruction(migraphx::make_op("log"), sum);
+
+    std::vector<float> x_data(s.elements());
+    std::iota(x_data.begin(), x_data.end(), -3.0f);
+    std::transform(
+        x_data.begin(), x_data.end(), x_data.begin(), [](auto v) { return v / 10.0f; });
+    migraphx::parameter_map params;
+    params["x"] = migraphx::argument(s, x_data.data());
+
+    auto gold = eval_unfused(p, params);
+    EXPECT(migraphx::verify::verify_rms_range(eval_fused(p, params), gold));
+}
+
+TEST_CASE(fused_reduce_new_programs)
+{
+    // A submodule of a later program can reuse the address of one that was destroyed
+    migraphx::shape s{migraphx::shape::float_type, {4, 6}};
+    std::vector<float> x_data(s.elements());
+    std::iota(x_data.begin(), x_data.end(), -0.5f);
+    migraphx::parameter_map params;
+    params["x"] = migraphx::argument(s, x_data.data());
+    for(const std::string name : {"exp", "neg", "abs", "exp"})
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        auto x   = mm->add_parameter("x", s);
+        auto y   = mm->add_instruction(migraphx::make_op(name), x);
+        mm->add_instruction(migraphx::make_op("reduce_sum", {{"axes", {1}}}), y);
+
+        auto gold = eval_unfused(p, params);
+        EXPECT(migraphx::verify::verify_rms_range(eval_fused(p, params), gold));
+    }
+}
@@ -30,7 +30,8 @@
 
 #include "test.hpp"
 
-static auto run_prog(int64_t iter_num, bool cond, int64_t ini_val)
+static auto
+run_prog(int64_t iter_num, bool cond, int64_t ini_val, bool trim = false, int64_t direction = 0)
 {
     migraphx::shape si{migraphx::shape::int64_type};
     migraphx::shape s{migraphx::shape::int64_type, {1}};
@@ -58,9 +59,13 @@ static auto run_prog(int64_t iter_num, bool cond, int64_t ini_val)
         auto neq = body->add_instruction(migraphx::make_op("not"), beq);
         body->add_return({neq, val, val});
 
-        auto rl = mm->add_instruction(migraphx::make_op("loop", {{"max_iterations", 10}}),
-                                      {in_iter, in_cond, in_val},
-                                      {body});
+        auto rl = mm->add_instruction(
+            migraphx::make_op("loop",
+                              {{"max_iterations", 10},
+                               {"scan_output_directions", {direction}},
+                               {"trim_scan_outputs", trim}}),
+            {in_iter, in_cond, in_val},
+            {body});
         auto r0 = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), rl);
         auto r1 = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 1}}), rl);
         mm->add_return({r0, r1});
@@ -122,3 +127,106 @@ TEST_CASE(loop_test4)
     std::vector<int64_t> gold_concat = {5, 9, 14, 20, 0, 0, 0, 0, 0, 0};
     EXPECT(ress.back() == gold_concat);
 }
+
+TEST_CASE(loop_trim_scan_outputs_test1)
+{
+    auto ress                      = run_prog(10, true, 1, true);
+    std::vector<int64_t> gold_last = {19};
+    EXPECT(ress.front() == gold_last);
+    std::vector<int64_t> gold_concat = {4, 8, 13, 19};
+    EXPECT(ress.back() == gold_concat);
+}
+
+TEST_CASE(loop_trim_scan_outputs_test2)
+{
+    auto ress                      = run_prog(3, true, 1, true);
+    std::vector<int64_t> gold_last = {13};
+    EXPECT(ress.front() == gold_last);
+    std::vector<int64_t> gold_concat = {4, 8, 13};
+    EXPECT(ress.back() == gold_concat);
+}
+
+TEST_CASE(loop_trim_scan_outputs_reverse_test1)
+{
+    auto ress                      = run_prog(10, true, 1, true, 1);
+    std::vector<int64_t> gold_last = {19};
+    EXPECT(ress.front() == gold_last);
+    std::vector<int64_t> gold_concat = {19, 13, 8, 4};
+    EXPECT(ress.back() == gold_concat);
+}
+
+TEST_CASE(loop_trim_scan_outputs_reverse_test2)
+{
+    auto ress                      = run_prog(3, true, 1, true, 1);
+    std::vector<int64_t> gold_last = {13};
+    EXPECT(ress.front() == gold_last);
+    std::vector<int64_t> gold_concat = {13, 8, 4};
+    EXPECT(ress.back() == gold_concat);
+}
+
+TEST_CASE(loop_output_params_test)
+{
+    // The body writes its carried state and scan output through output
+    // parameters, so run_loop binds them to the loop buffers directly
+    migraphx::shape si{migraphx::shape::int64_type};
+    migraphx::shape s{migraphx::shape::int64_type, {1}};
+    migraphx::shape sc{migraphx::shape::bool_type};
+    auto run = [&](int64_t iter_num, bool trim) {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+
+        auto in_iter = mm->add_parameter("iter_num", si);
+        auto in_cond = mm->add_parameter("ccond", sc);
+        auto in_val  = mm->add_parameter("val", s);
+
+        auto* body = p.create_module("loop_module");
+        auto iter  = body->add_parameter("#loop_module_in_0", si);
+        body->add_parameter("#loop_module_in_1", sc);
+        auto in_v     = body->add_parameter("#loop_module_in_2", s);
+        auto out_dep  = body->add_parameter("loop_module:#output_1", s);
+        auto out_scan = body->add_parameter("loop_module:#output_2", s);
+        auto l        = body->add_literal(int64_t{3});
+        auto ad       = body->add_instruction(migraphx::make_op("add"), iter, l);
+        auto val      = body->add_instruction(migraphx::make_op("add"), in_v, ad);
+        auto dep      = body->add_instruction(migraphx::make_op("fill"), val, out_dep);
+        auto scan     = body->add_instruction(migraphx::make_op("fill"), val, out_scan);
+        auto eq       = body->add_instruction(migraphx::make_op("equal"), iter, l);
+        auto beq      = body->add_instruction(
+            migraphx::make_op("convert", {{"target_type", migraphx::shape::bool_type}}), eq);
+        auto neq = body->add_instruction(migraphx::make_op("not"), beq);
+        body->add_return({neq, dep, scan});
+
+        auto rl = mm->add_instruction(
+            migraphx::make_op("loop", {{"max_iterations", 10}, {"trim_scan_outputs", trim}}),
+            {in_iter, in_cond, in_val},
+            {body});
+        auto r0 = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), rl);
+        auto r1 = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 1}}), rl);
+        mm->add_return({r0, r1});
+        p.compile(migraphx::make_target("ref"));
+
+        int64_t ini_val = 1;
+        bool cond       = true;
+        migraphx::parameter_map pp;
+        pp["iter_num"] = migraphx::argument(si, &iter_num);
+        pp["ccond"]    = migraphx::argument(sc, &cond);
+        pp["val"]      = migraphx::argument(s, &ini_val);
+        auto rets      = p.eval(pp);
+        EXPECT(ini_val == 1);
+        std::vector<std::vector<int64_t>> res;
+        for(auto& arg : rets)
+        {
+            std::vector<int64_t> vec;
+            arg.visit([&](auto v) { vec.assign(v.begin(), v.end()); });
+            res.push_back(vec);
+        }
+        return res;
+    };
+
+    auto ress = run(10, false);
+    EXPECT(ress.front() == std::vector<int64_t>{19});
+    EXPECT(ress.back() == std::vector<int64_t>{4, 8, 13, 19, 0, 0, 0, 0, 0, 0});
+    auto trimmed = run(3, true);
+    EXPECT(trimmed.front() == std::vector<int64_t>{13});
+    EXPECT(trimmed.back() == std::vector<int64_t>{4, 8, 13});
+}
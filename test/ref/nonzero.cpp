@@ -48,3 +48,30 @@ TEST_CASE(nonzero_test)
                                  1, 1, 0, 0, 0, 0, 0, 1, 0, 2, 0, 2, 0, 2, 0, 0, 0, 0};
     EXPECT(migraphx::verify::verify_rms_range(result_vector, gold));
 }
+
+// Large enough to be split into several blocks, some of them without any
+// nonzeros
+TEST_CASE(nonzero_sparse_large_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {3, 5000}};
+    std::vector<std::size_t> positions = {1, 4095, 4096, 9000, 14999};
+    std::vector<float> data(s.elements(), 0.0f);
+    for(auto i : positions)
+        data[i] = 1.0f + i;
+    auto input = mm->add_literal(migraphx::literal(s, data));
+    auto ret   = mm->add_instruction(migraphx::make_op("nonzero"), input);
+    mm->add_return({ret});
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval({}).back();
+    std::vector<int64_t> result_vector;
+    result.visit([&](auto output) { result_vector.assign(output.begin(), output.end()); });
+    std::vector<int64_t> gold(2 * s.elements(), 0);
+    for(std::size_t j = 0; j < positions.size(); j++)
+    {
+        gold[j]                = positions[j] / 5000;
+        gold[s.elements() + j] = positions[j] % 5000;
+    }
+    EXPECT(result_vector == gold);
+}
@@ -0,0 +1,326 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/instruction.hpp>
+#include <migraphx/literal.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/kv_block_allocator.hpp>
+#include <migraphx/verify.hpp>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include <test.hpp>
+
+TEST_CASE(paged_concat_past_present_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape cache_s{migraphx::shape::float_type, {4, 1, 2, 2}};
+    migraphx::shape present_s{migraphx::shape::float_type, {2, 1, 1, 2}};
+    migraphx::shape table_s{migraphx::shape::int32_type, {2, 2}};
+    migraphx::shape seqlens_s{migraphx::shape::int32_type, {2}};
+    auto cache   = mm->add_parameter("cache", cache_s);
+    auto present = mm->add_literal(migraphx::literal{present_s, {1, 2, 3, 4}});
+    auto table   = mm->add_literal(migraphx::literal{table_s, {2, 0, 1, 3}});
+    auto seqlens = mm->add_literal(migraphx::literal{seqlens_s, {2, 0}});
+    mm->add_instruction(
+        migraphx::make_op("paged_concat_past_present"), cache, present, table, seqlens);
+    p.compile(migraphx::make_target("ref"));
+
+    std::vector<float> data(cache_s.elements(), 0);
+    migraphx::parameter_map pp;
+    pp["cache"] = migraphx::argument(cache_s, data.data());
+    auto result = p.eval(pp).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    // Token 2 of the first sequence goes to block 0, row 0 and token 0 of
+    // the second sequence goes to block 1, row 0
+    std::vector<float> gold = {1, 2, 0, 0, 3, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    EXPECT(results_vector == gold);
+}
+
+TEST_CASE(paged_attention_test)
+{
+    const std::size_t num_heads   = 2;
+    const std::size_t head_size   = 2;
+    const std::size_t block_size  = 2;
+    const std::size_t max_blocks  = 3;
+    std::vector<std::size_t> lens = {3, 5};
+
+    migraphx::kv_block_allocator allocator{6, block_size};
+    // Interleave the allocations so the sequences use non-contiguous blocks
+    for(std::size_t i = 0; i < 5; ++i)
+    {
+        for(std::size_t seq = 0; seq < lens.size(); ++seq)
+        {
+            if(i < lens[seq])
+                EXPECT(allocator.append(seq));
+        }
+    }
+
+    migraphx::shape q_s{migraphx::shape::float_type, {2, 1, num_heads * head_size}};
+    migraphx::shape cache_s{migraphx::shape::float_type, {6, 1, block_size, head_size}};
+    std::vector<float> query(q_s.elements());
+    std::vector<float> keys(cache_s.elements());
+    std::vector<float> values(cache_s.elements());
+    std::iota(query.begin(), query.end(), 0.5f);
+    for(std::size_t i = 0; i < keys.size(); ++i)
+    {
+        keys[i]   = std::sin(0.3f * i);
+        values[i] = std::cos(0.7f * i);
+    }
+
+    migraphx::program p;
+    auto* mm        = p.get_main_module();
+    auto q          = mm->add_literal(migraphx::literal{q_s, query});
+    auto k          = mm->add_literal(migraphx::literal{cache_s, keys});
+    auto v          = mm->add_literal(migraphx::literal{cache_s, values});
+    auto to_literal = [](const migraphx::argument& a) {
+        return migraphx::literal{a.get_shape(), a.data()};
+    };
+    auto bt   = mm->add_literal(to_literal(allocator.make_block_table({0, 1}, max_blocks)));
+    auto seqs = mm->add_literal(to_literal(allocator.make_seqlens_k({0, 1})));
+    mm->add_instruction(
+        migraphx::make_op("paged_attention", {{"num_heads", num_heads}, {"kv_num_heads", 1}}),
+        q,
+        k,
+        v,
+        bt,
+        seqs);
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval({}).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+
+    // Dense attention over the tokens gathered through the block table
+    std::vector<float> gold;
+    for(std::size_t b = 0; b < lens.size(); ++b)
+    {
+        const auto& blocks = allocator.blocks(b);
+        for(std::size_t n = 0; n < num_heads; ++n)
+        {
+            auto qn = query.begin() + (b * num_heads + n) * head_size;
+            std::vector<double> scores;
+            for(std::size_t t = 0; t < lens[b]; ++t)
+            {
+                auto kt = keys.begin() + (blocks[t / block_size] * block_size + t % block_size) *
+                                             head_size;
+                scores.push_back(std::inner_product(qn, qn + head_size, kt, 0.0) /
+                                 std::sqrt(double(head_size)));
+            }
+            double mx  = *std::max_element(scores.begin(), scores.end());
+            double sum = 0;
+            for(auto& s : scores)
+            {
+                s = std::exp(s - mx);
+                sum += s;
+            }
+            for(std::size_t d = 0; d < head_size; ++d)
+            {
+                double acc = 0;
+                for(std::size_t t = 0; t < lens[b]; ++t)
+                {
+                    auto vt = (blocks[t / block_size] * block_size + t % block_size) * head_size;
+                    acc += scores[t] / sum * values[vt + d];
+                }
+                gold.push_back(acc);
+            }
+        }
+    }
+    EXPECT(migraphx::verify::verify_rms_range(results_vector, gold));
+}
+
+// Run the same attention with group_query_attention on a contiguous kv-cache
+// and with paged_concat_past_present and paged_attention on a paged kv-cache.
+// Each sequence has past_lens[b] tokens in the cache before the new ones.
+static void check_paged_attention_gqa(std::size_t seq_len,
+                                      const std::vector<std::size_t>& past_lens,
+                                      int local_window_size)
+{
+    const std::size_t batch_size   = past_lens.size();
+    const std::size_t num_heads    = 4;
+    const std::size_t kv_num_heads = 2;
+    const std::size_t head_size    = 4;
+    const std::size_t max_seq_len  = 8;
+    const std::size_t block_size   = 2;
+    const std::size_t num_blocks   = batch_size * max_seq_len / block_size;
+    const std::size_t max_blocks   = max_seq_len / block_size;
+    const std::size_t packed_heads = num_heads + 2 * kv_num_heads;
+    const float scale              = 0.5;
+    auto dtype                     = migraphx::shape::float_type;
+
+    migraphx::shape qkv_s{dtype, {batch_size, seq_len, packed_heads * head_size}};
+    migraphx::shape past_s{dtype, {batch_size, kv_num_heads, max_seq_len, head_size}};
+    std::vector<float> qkv(qkv_s.elements());
+    std::vector<float> past_k(past_s.elements());
+    std::vector<float> past_v(past_s.elements());
+    for(std::size_t i = 0; i < qkv.size(); ++i)
+        qkv[i] = std::sin(0.37f * i);
+    for(std::size_t i = 0; i < past_k.size(); ++i)
+    {
+        past_k[i] = std::cos(0.23f * i);
+        past_v[i] = std::sin(0.71f * i + 1);
+    }
+    // Element d of head j of token s of the packed query, keys and values
+    auto packed = [&](std::size_t b, std::size_t s, std::size_t j, std::size_t d) {
+        return qkv[((b * seq_len + s) * packed_heads + j) * head_size + d];
+    };
+
+    std::vector<int32_t> seqlens(batch_size);
+    std::transform(past_lens.begin(), past_lens.end(), seqlens.begin(), [&](auto past) {
+        return static_cast<int32_t>(past + seq_len - 1);
+    });
+
+    migraphx::program gqa;
+    {
+        auto* mm = gqa.get_main_module();
+        migraphx::shape slk_s{migraphx::shape::int32_type, {batch_size, 1}};
+        migraphx::shape cs_s{dtype, {max_seq_len, head_size / 2}};
+        auto query = mm->add_literal(migraphx::literal{qkv_s, qkv});
+        auto key   = mm->add_literal(0.0f);
+        auto value = mm->add_literal(0.0f);
+        auto pk    = mm->add_literal(migraphx::literal{past_s, past_k});
+        auto pv    = mm->add_literal(migraphx::literal{past_s, past_v});
+        auto slk   = mm->add_literal(migraphx::literal{slk_s, seqlens});
+        auto tsl   = mm->add_literal(migraphx::literal{
+            migraphx::shape{migraphx::shape::int32_type, {1, 1}}, {int32_t(max_seq_len)}});
+        auto cs    = mm->add_literal(migraphx::literal{cs_s, std::vector<float>(cs_s.elements())});
+        auto r     = mm->add_instruction(migraphx::make_op("group_query_attention",
+                                                          {{"do_rotary", 0},
+                                                           {"kv_num_heads", kv_num_heads},
+                                                           {"local_window_size", local_window_size},
+                                                           {"num_heads", num_heads},
+                                                           {"scale", scale}}),
+                                     query,
+                                     key,
+                                     value,
+                                     pk,
+                                     pv,
+                                     slk,
+                                     tsl,
+                                     cs,
+                                     cs);
+        mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), r);
+    }
+    gqa.compile(migraphx::make_target("ref"));
+    std::vector<float> gold;
+    gqa.eval({}).back().visit([&](auto output) { gold.assign(output.begin(), output.end()); });
+
+    migraphx::kv_block_allocator allocator{num_blocks, block_size};
+    std::vector<std::size_t> seq_ids(batch_size);
+    std::iota(seq_ids.begin(), seq_ids.end(), 0);
+    migraphx::shape cache_s{dtype, {num_blocks, kv_num_heads, block_size, head_size}};
+    std::vector<float> key_cache(cache_s.elements());
+    std::vector<float> value_cache(cache_s.elements());
+    for(std::size_t b = 0; b < batch_size; ++b)
+    {
+        if(past_lens[b] == 0)
+            continue;
+        EXPECT(allocator.append(b, past_lens[b]));
+        const auto& blocks = allocator.blocks(b);
+        for(std::size_t h = 0; h < kv_num_heads; ++h)
+        {
+            for(std::size_t t = 0; t < past_lens[b]; ++t)
+            {
+                auto block = static_cast<std::size_t>(blocks[t / block_size]);
+                auto dst   = ((block * kv_num_heads + h) * block_size + t % block_size) * head_size;
+                auto src   = ((b * kv_num_heads + h) * max_seq_len + t) * head_size;
+                std::copy(past_k.begin() + src, past_k.begin() + src + head_size, &key_cache[dst]);
+                std::copy(
+                    past_v.begin() + src, past_v.begin() + src + head_size, &value_cache[dst]);
+            }
+        }
+    }
+    for(std::size_t b = 0; b < batch_size; ++b)
+        EXPECT(allocator.append(b, seq_len));
+
+    migraphx::shape q_s{dtype, {batch_size, seq_len, num_heads * head_size}};
+    migraphx::shape present_s{dtype, {batch_size, kv_num_heads, seq_len, head_size}};
+    std::vector<float> query(q_s.elements());
+    std::vector<float> present_k(present_s.elements());
+    std::vector<float> present_v(present_s.elements());
+    for(std::size_t b = 0; b < batch_size; ++b)
+    {
+        for(std::size_t s = 0; s < seq_len; ++s)
+        {
+            for(std::size_t d = 0; d < head_size; ++d)
+            {
+                for(std::size_t n = 0; n < num_heads; ++n)
+                    query[((b * seq_len + s) * num_heads + n) * head_size + d] = packed(b, s, n, d);
+                for(std::size_t h = 0; h < kv_num_heads; ++h)
+                {
+                    auto i       = ((b * kv_num_heads + h) * seq_len + s) * head_size + d;
+                    present_k[i] = packed(b, s, num_heads + h, d);
+                    present_v[i] = packed(b, s, num_heads + kv_num_heads + h, d);
+                }
+            }
+        }
+    }
+
+    migraphx::program paged;
+    {
+        auto* mm        = paged.get_main_module();
+        auto to_literal = [](const migraphx::argument& a) {
+            return migraphx::literal{a.get_shape(), a.data()};
+        };
+        auto kc = mm->add_parameter("key_cache", cache_s);
+        auto vc = mm->add_parameter("value_cache", cache_s);
+        auto q  = mm->add_literal(migraphx::literal{q_s, query});
+        auto pk = mm->add_literal(migraphx::literal{present_s, present_k});
+        auto pv = mm->add_literal(migraphx::literal{present_s, present_v});
+        auto bt = mm->add_literal(to_literal(allocator.make_block_table(seq_ids, max_blocks)));
+        auto sk = mm->add_literal(to_literal(allocator.make_seqlens_k(seq_ids)));
+        auto concat = migraphx::make_op("paged_concat_past_present");
+        kc          = mm->add_instruction(concat, kc, pk, bt, sk);
+        vc          = mm->add_instruction(concat, vc, pv, bt, sk);
+        mm->add_instruction(migraphx::make_op("paged_attention",
+                                              {{"num_heads", num_heads},
+                                               {"kv_num_heads", kv_num_heads},
+                                               {"local_window_size", local_window_size},
+                                               {"scale", scale}}),
+                            q,
+                            kc,
+                            vc,
+                            bt,
+                            sk);
+    }
+    paged.compile(migraphx::make_target("ref"));
+    migraphx::parameter_map pp;
+    pp["key_cache"]   = migraphx::argument(cache_s, key_cache.data());
+    pp["value_cache"] = migraphx::argument(cache_s, value_cache.data());
+    std::vector<float> results_vector;
+    paged.eval(pp).back().visit(
+        [&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify::verify_rms_range(results_vector, gold));
+}
+
+TEST_CASE(paged_attention_gqa_prompt) { check_paged_attention_gqa(3, {0, 0}, -1); }
+
+TEST_CASE(paged_attention_gqa_prompt_local_window) { check_paged_attention_gqa(5, {0, 0}, 2); }
+
+TEST_CASE(paged_attention_gqa_decode) { check_paged_attention_gqa(1, {3, 6}, -1); }
+
+TEST_CASE(paged_attention_gqa_decode_local_window) { check_paged_attention_gqa(1, {3, 6}, 2); }
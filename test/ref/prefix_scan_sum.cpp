@@ -300,3 +300,33 @@ TEST_CASE(prefix_scan_sum_reverse_2)
     std::vector<float> gold{2.0, 4.0, 6.0, 8.0, 1.0, 2.0, 3.0, 4.0};
     EXPECT(results_vector == gold);
 }
+
+TEST_CASE(prefix_scan_sum_long_axis)
+{
+    // Long enough for the axis to be scanned in parallel blocks
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::int32_type, {2, 10000}};
+    std::vector<int> data(s.elements());
+    for(std::size_t i = 0; i < data.size(); i++)
+        data[i] = i % 7;
+    auto l0 = mm->add_literal(migraphx::literal{s, data});
+    mm->add_instruction(migraphx::make_op("prefix_scan_sum",
+                                          {{"axis", 1}, {"exclusive", true}, {"reverse", true}}),
+                        l0);
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval({}).back();
+    std::vector<int> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<int> gold(data.size());
+    for(std::size_t b = 0; b < 2; b++)
+    {
+        int sum = 0;
+        for(std::size_t i = 10000; i > 0; i--)
+        {
+            gold[b * 10000 + i - 1] = sum;
+            sum += data[b * 10000 + i - 1];
+        }
+    }
+    EXPECT(results_vector == gold);
+}
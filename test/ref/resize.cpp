@@ -393,6 +393,43 @@ TEST_CASE(resize_optimize_test)
     EXPECT(migraphx::verify::verify_rms_range(res_data, golden));
 }
 
+TEST_CASE(resize_transposed_input_test)
+{
+    // The input is read through its strides, so a transposed input must give
+    // the same result as a contiguous copy of it
+    auto run = [](bool contiguous) {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+
+        std::vector<float> data(2 * 3 * 4);
+        std::iota(data.begin(), data.end(), 0.5);
+        migraphx::shape s{migraphx::shape::float_type, {1, 2, 3, 4}};
+        auto a0 = mm->add_literal(migraphx::literal{s, data});
+        a0      = mm->add_instruction(
+            migraphx::make_op("transpose", {{"permutation", {0, 1, 3, 2}}}), a0);
+        if(contiguous)
+            a0 = mm->add_instruction(migraphx::make_op("contiguous"), a0);
+        migraphx::shape size_input{migraphx::shape::int32_type, {4}};
+        std::vector<int> size_values = {1, 2, 7, 5};
+        auto a1                      = mm->add_literal(migraphx::literal{size_input, size_values});
+        mm->add_instruction(migraphx::make_op("resize",
+                                              {{"sizes", {1}},
+                                               {"scales", {1}},
+                                               {"nearest_mode", "round_prefer_ceil"},
+                                               {"coordinate_transformation_mode", "half_pixel"}}),
+                            a0,
+                            a1);
+        p.compile(migraphx::make_target("ref"));
+        auto result = p.eval({}).back();
+        std::vector<float> res_data;
+        result.visit([&](auto output) { res_data.assign(output.begin(), output.end()); });
+        return res_data;
+    };
+    auto golden = run(true);
+    EXPECT(golden.size() == 2 * 7 * 5);
+    EXPECT(run(false) == golden);
+}
+
 TEST_CASE(resize_fail_test_1)
 {
     // invalid resize mode
@@ -29,6 +29,7 @@
 #include <migraphx/verify.hpp>
 
 #include <test.hpp>
+#include <limits>
 
 TEST_CASE(topk_test)
 {
@@ -81,3 +82,59 @@ TEST_CASE(topk_test)
         EXPECT(results.second == gold_ind);
     }
 }
+
+TEST_CASE(topk_ties_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {4, 2}};
+    auto data = mm->add_parameter("data", s);
+    auto r    = mm->add_instruction(
+        migraphx::make_op("topk", {{"axis", 0}, {"k", 2}, {"largest", 1}}), data);
+    auto r0 = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), r);
+    auto r1 = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 1}}), r);
+    mm->add_return({r0, r1});
+    p.compile(migraphx::make_target("ref"));
+
+    std::vector<float> input = {1, 5, 3, 5, 3, 4, 2, 5};
+    migraphx::parameter_map pp;
+    pp["data"] = migraphx::argument(s, input.data());
+    auto rets  = p.eval(pp);
+    std::vector<float> ret_val;
+    rets.front().visit([&](auto v) { ret_val.assign(v.begin(), v.end()); });
+    std::vector<int64_t> ret_ind;
+    rets.back().visit([&](auto v) { ret_ind.assign(v.begin(), v.end()); });
+
+    std::vector<float> gold_val = {3, 5, 3, 5};
+    EXPECT(ret_val == gold_val);
+    std::vector<int64_t> gold_ind = {1, 0, 2, 1};
+    EXPECT(ret_ind == gold_ind);
+}
+
+TEST_CASE(topk_nan_test)
+{
+    auto run = [](bool largest) {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape s{migraphx::shape::float_type, {6}};
+        auto data = mm->add_parameter("data", s);
+        auto r    = mm->add_instruction(
+            migraphx::make_op("topk", {{"axis", 0}, {"k", 4}, {"largest", largest}}), data);
+        auto r0 = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), r);
+        auto r1 = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 1}}), r);
+        mm->add_return({r0, r1});
+        p.compile(migraphx::make_target("ref"));
+
+        auto nan                 = std::numeric_limits<float>::quiet_NaN();
+        std::vector<float> input = {1, nan, 3, nan, 2, 3};
+        migraphx::parameter_map pp;
+        pp["data"] = migraphx::argument(s, input.data());
+        auto rets  = p.eval(pp);
+        std::vector<int64_t> ret_ind;
+        rets.back().visit([&](auto v) { ret_ind.assign(v.begin(), v.end()); });
+        return ret_ind;
+    };
+    // NaN orders above every number, and equal values keep the lower index first
+    EXPECT(run(true) == std::vector<int64_t>{1, 3, 2, 5});
+    EXPECT(run(false) == std::vector<int64_t>{0, 4, 2, 5});
+}
@@ -27,6 +27,8 @@
 #include <migraphx/onnx.hpp>
 #include <migraphx/register_target.hpp>
 #include <migraphx/verify.hpp>
+#include <algorithm>
+#include <cmath>
 #include <optional>
 #include <test.hpp>
 
@@ -340,3 +342,96 @@ TEST_CASE(unique_subtensors_zero_axis_test)
     std::vector<int64_t> gold_ct = {2};
     EXPECT(ct == gold_ct);
 }
+
+// 0 and -0 compare equal so they are the same unique value, which keeps the
+// value of its first occurrence
+TEST_CASE(unique_signed_zero_test)
+{
+    for(int64_t sorted : {0, 1})
+    {
+        std::vector<float> data  = {-0.0f, 1.0f, 0.0f, -0.0f, 1.0f};
+        std::vector<size_t> lens = {5};
+        migraphx::shape data_shape{migraphx::shape::float_type, lens};
+        const auto& [y, idx, x_rev, ct] = run_program(data, data_shape, sorted);
+
+        std::vector<float> gold_val = {0.0f, 1.0f};
+        EXPECT(y == gold_val);
+        EXPECT(std::signbit(y.front()));
+
+        std::vector<int64_t> gold_y_idx = {0, 1};
+        EXPECT(idx == gold_y_idx);
+
+        std::vector<int64_t> gold_x_rev = {0, 1, 0, 0, 1};
+        EXPECT(x_rev == gold_x_rev);
+
+        std::vector<int64_t> gold_ct = {3, 2};
+        EXPECT(ct == gold_ct);
+    }
+}
+
+// Sub-tensors that hold the same values in a different order are different
+TEST_CASE(unique_subtensors_permuted_test)
+{
+    int axis                 = 0;
+    int sorted               = 1;
+    std::vector<int> data    = {1, 2, 2, 1, 1, 2, 0, 3, 3, 0, 2, 1};
+    std::vector<size_t> lens = {6, 2};
+    migraphx::shape data_shape{migraphx::shape::int32_type, lens};
+    const auto& [y, idx, x_rev, ct] = run_program(data, data_shape, sorted, axis);
+
+    std::vector<int> gold_val = {0, 3, 1, 2, 2, 1, 3, 0};
+    EXPECT(y == gold_val);
+
+    std::vector<int64_t> gold_y_idx = {3, 0, 1, 4};
+    EXPECT(idx == gold_y_idx);
+
+    std::vector<int64_t> gold_x_rev = {1, 2, 1, 0, 3, 2};
+    EXPECT(x_rev == gold_x_rev);
+
+    std::vector<int64_t> gold_ct = {1, 2, 2, 1};
+    EXPECT(ct == gold_ct);
+}
+
+// Enough repeated sub-tensors that chunks share slots of the hash table,
+// checked against a linear search for the first occurrence of each one
+TEST_CASE(unique_subtensors_many_dupes_test)
+{
+    int axis                 = 0;
+    int sorted               = 0;
+    std::vector<size_t> lens = {300, 3};
+    std::vector<int> data(lens[0] * lens[1]);
+    for(size_t i = 0; i < lens[0]; i++)
+    {
+        data[i * 3]     = i % 7;
+        data[i * 3 + 1] = i % 5;
+        data[i * 3 + 2] = (i % 7) * (i % 5);
+    }
+    migraphx::shape data_shape{migraphx::shape::int32_type, lens};
+    const auto& [y, idx, x_rev, ct] = run_program(data, data_shape, sorted, axis);
+
+    std::vector<int> gold_val;
+    std::vector<int64_t> gold_y_idx;
+    std::vector<int64_t> gold_x_rev;
+    std::vector<int64_t> gold_ct;
+    for(size_t i = 0; i < lens[0]; i++)
+    {
+        auto row = data.begin() + i * 3;
+        size_t j = 0;
+        while(j < gold_y_idx.size() and
+              not std::equal(row, row + 3, data.begin() + gold_y_idx[j] * 3))
+            j++;
+        if(j == gold_y_idx.size())
+        {
+            gold_val.insert(gold_val.end(), row, row + 3);
+            gold_y_idx.push_back(i);
+            gold_ct.push_back(0);
+        }
+        gold_ct[j]++;
+        gold_x_rev.push_back(j);
+    }
+    EXPECT(gold_y_idx.size() == 35);
+    EXPECT(y == gold_val);
+    EXPECT(idx == gold_y_idx);
+    EXPECT(x_rev == gold_x_rev);
+    EXPECT(ct == gold_ct);
+}
@@ -29,6 +29,7 @@
 #include <migraphx/shape.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/register_target.hpp>
+#include <numeric>
 #include "test.hpp"
 
 TEST_CASE(run_on_target_shape_tests)
@@ -71,4 +72,91 @@ TEST_CASE(eval_run_on_target)
     EXPECT(migraphx::verify::verify_rms_range(results_vector, gold));
 }
 
+migraphx::program create_pipelined_program(const std::string& target = "ref", std::size_t n = 3)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {n}};
+    auto x = mm->add_parameter("x", s);
+
+    auto* mod1 = p.create_module("mod1");
+    auto x1    = mod1->add_parameter("x1", s);
+    mod1->add_return({mod1->add_instruction(migraphx::make_op("rsqrt"), x1)});
+
+    auto* mod2 = p.create_module("mod2");
+    auto x2    = mod2->add_parameter("x2", s);
+    auto y2    = mod2->add_parameter("y2", s);
+    mod2->add_return({mod2->add_instruction(migraphx::make_op("add"), x2, y2)});
+
+    auto run1 =
+        mm->add_instruction(migraphx::make_op("run_on_target", {{"target_id", 0}}), {x}, {mod1});
+    auto r1 = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), run1);
+    auto run2 = mm->add_instruction(
+        migraphx::make_op("run_on_target", {{"target_id", 0}}), {r1, x}, {mod2});
+    auto r2 = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), run2);
+    mm->add_return({r1, r2});
+    p.compile({migraphx::make_target(target)});
+    return p;
+}
+
+TEST_CASE(eval_pipelined_run_on_target)
+{
+    auto p = create_pipelined_program();
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    std::vector<std::vector<float>> inputs;
+    std::vector<migraphx::parameter_map> batches;
+    for(std::size_t i = 0; i < 7; i++)
+    {
+        float v = 4.0f * (i + 1);
+        inputs.push_back({v, 2 * v, 4 * v});
+        batches.push_back({{"x", migraphx::argument{s, inputs.back().data()}}});
+    }
+    auto results = p.eval_pipelined(batches, 1);
+    EXPECT(results.size() == batches.size());
+    for(std::size_t i = 0; i < batches.size(); i++)
+    {
+        auto gold = p.eval(batches[i]);
+        EXPECT(results[i].size() == 2);
+        EXPECT(results[i].front() == gold.front());
+        EXPECT(results[i].back() == gold.back());
+    }
+}
+
+#ifdef HAVE_CPU
+// The cpu target returns results from its scratch memory, which is reused by
+// every evaluation of the same stage
+TEST_CASE(eval_pipelined_cpu)
+{
+    auto p = create_pipelined_program("cpu", 64);
+    migraphx::shape s{migraphx::shape::float_type, {64}};
+    std::vector<std::vector<float>> inputs;
+    std::vector<migraphx::parameter_map> batches;
+    for(std::size_t i = 0; i < 9; i++)
+    {
+        inputs.emplace_back(s.elements());
+        std::iota(inputs.back().begin(), inputs.back().end(), 1.0f + 64 * i);
+        batches.push_back({{"x", migraphx::argument{s, inputs.back().data()}}});
+    }
+    auto results = p.eval_pipelined(batches, 2);
+    EXPECT(results.size() == batches.size());
+    for(std::size_t i = 0; i < batches.size(); i++)
+    {
+        auto gold = p.eval(batches[i]);
+        EXPECT(results[i].size() == 2);
+        EXPECT(results[i].front() == gold.front());
+        EXPECT(results[i].back() == gold.back());
+    }
+}
+#endif
+
+TEST_CASE(eval_pipelined_error)
+{
+    auto p = create_pipelined_program();
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    std::vector<float> input = {1, 2, 3};
+    std::vector<migraphx::parameter_map> batches(4, {{"x", migraphx::argument{s, input.data()}}});
+    batches[2].clear();
+    EXPECT(test::throws([&] { p.eval_pipelined(batches); }));
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
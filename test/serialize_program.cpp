@@ -26,6 +26,7 @@
 #include <migraphx/load_save.hpp>
 #include "test.hpp"
 #include <migraphx/make_op.hpp>
+#include <migraphx/instruction.hpp>
 
 #include <cstdio>
 
@@ -88,6 +89,28 @@ TEST_CASE(compiled)
     EXPECT(p1.sort() == p2.sort());
 }
 
+TEST_CASE(intern_literals)
+{
+    auto get_literal_data = [](const migraphx::program& p) {
+        auto* mm = p.get_main_module();
+        auto lit = std::find_if(mm->begin(), mm->end(), [](const migraphx::instruction& ins) {
+            return ins.name() == "@literal";
+        });
+        return lit->get_literal().data();
+    };
+    std::vector<char> buffer = migraphx::save_buffer(create_program());
+    migraphx::program p1     = migraphx::load_buffer(buffer);
+    migraphx::program p2     = migraphx::load_buffer(buffer);
+    EXPECT(get_literal_data(p1) != get_literal_data(p2));
+
+    migraphx::file_options options;
+    options.intern_literals = true;
+    migraphx::program p3    = migraphx::load_buffer(buffer, options);
+    migraphx::program p4    = migraphx::load_buffer(buffer, options);
+    EXPECT(get_literal_data(p3) == get_literal_data(p4));
+    EXPECT(p1.sort() == p3.sort());
+}
+
 TEST_CASE(unknown_format)
 {
     migraphx::file_options options;
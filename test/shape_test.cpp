@@ -26,6 +26,7 @@
 #include <migraphx/serialize.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/permutation.hpp>
+#include <migraphx/par_for.hpp>
 #include <migraphx/stringutils.hpp>
 #include <array>
 #include <algorithm>
@@ -1174,4 +1175,73 @@ TEST_CASE(shape_is_compatible_diff_lens_tuple)
     EXPECT(not migraphx::shape::is_compatible(actual, expected));
 }
 
+TEST_CASE(shape_interned_equal)
+{
+    migraphx::shape s1{migraphx::shape::float_type, {2, 3, 4}};
+    migraphx::shape s2{migraphx::shape::float_type, {2, 3, 4}, {12, 4, 1}};
+    migraphx::shape s3{migraphx::shape::float_type, {2, 3, 4}, {1, 2, 6}};
+    migraphx::shape s4{migraphx::shape::half_type, {2, 3, 4}};
+    EXPECT(s1 == s2);
+    EXPECT(s2.standard());
+    EXPECT(s1 != s3);
+    EXPECT(not s3.standard());
+    EXPECT(s1 != s4);
+    EXPECT(s1.with_type(migraphx::shape::half_type) == s4);
+    EXPECT(s4.with_type(migraphx::shape::float_type) == s1);
+}
+
+TEST_CASE(shape_interned_scalar)
+{
+    migraphx::shape s1{migraphx::shape::int32_type};
+    migraphx::shape s2{migraphx::shape::int32_type, {1}, {0}};
+    migraphx::shape s3{migraphx::shape::int32_type, {1}};
+    EXPECT(s1 == s2);
+    EXPECT(s1 != s3);
+    EXPECT(s1.scalar());
+    EXPECT(s1.standard());
+}
+
+TEST_CASE(shape_interned_large_rank)
+{
+    std::vector<std::size_t> lens = {2, 1, 3, 1, 2, 2, 1, 2};
+    migraphx::shape s1{migraphx::shape::float_type, lens};
+    migraphx::shape s2{migraphx::shape::float_type, lens, s1.strides()};
+    migraphx::shape s3{migraphx::shape::float_type, lens, {1, 2, 2, 6, 6, 12, 24, 24}};
+    EXPECT(s1 == s2);
+    EXPECT(s1 != s3);
+    EXPECT(s2.standard());
+    EXPECT(not s3.standard());
+}
+
+TEST_CASE(shape_interned_implicit_strides)
+{
+    // Shapes built with and without their standard strides must intern to the same impl
+    std::vector<std::size_t> lens = {5, 1, 3, 2, 4, 7};
+    for(std::size_t n = 1; n <= lens.size(); n++)
+    {
+        std::vector<std::size_t> sub(lens.begin(), lens.begin() + n);
+        migraphx::shape s1{migraphx::shape::float_type, sub};
+        migraphx::shape s2{migraphx::shape::float_type, sub, s1.strides()};
+        EXPECT(s1 == s2);
+        EXPECT(s2 == s1);
+        EXPECT(s2.standard());
+    }
+}
+
+TEST_CASE(shape_interned_repeated)
+{
+    // Shapes built again, in any order or thread, match the shapes built first
+    std::vector<migraphx::shape> shapes;
+    for(std::size_t i = 1; i <= 200; i++)
+        shapes.emplace_back(migraphx::shape::float_type, std::vector<std::size_t>{i, 3});
+    std::vector<int> same(2 * shapes.size(), 0);
+    migraphx::par_for(same.size(), [&](auto i) {
+        auto n = 1 + (i * 7) % shapes.size();
+        migraphx::shape s1{migraphx::shape::float_type, {n, 3}};
+        migraphx::shape s2{migraphx::shape::float_type, {n, 3}, {3, 1}};
+        same[i] = s1 == shapes[n - 1] and s2 == s1 and s1.lens() == shapes[n - 1].lens();
+    });
+    EXPECT(std::all_of(same.begin(), same.end(), [](int x) { return x == 1; }));
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,196 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/target.hpp>
+#include <migraphx/target_assignments.hpp>
+#include <migraphx/supported_segments.hpp>
+#include <migraphx/stringutils.hpp>
+#include <unordered_map>
+
+#include <test.hpp>
+
+// Target that supports the listed operators, each one as its own segment
+// with the given cost
+struct cost_target
+{
+    std::string target_name;
+    std::unordered_map<std::string, float> costs;
+
+    std::string name() const { return target_name; }
+    std::vector<migraphx::pass> get_passes(migraphx::context&,
+                                           const migraphx::compile_options&) const
+    {
+        return {};
+    }
+    migraphx::context get_context() const { return {}; }
+
+    migraphx::supported_segments find_supported(migraphx::const_module_ref mod,
+                                                migraphx::support_metric) const
+    {
+        migraphx::supported_segments result;
+        for(auto ins : migraphx::iterator_for(*mod))
+        {
+            auto name = migraphx::starts_with(ins->name(), "@") ? "@" : ins->name();
+            if(costs.count(name) == 0)
+                continue;
+            migraphx::supported_segment segment;
+            segment.instructions = {ins};
+            segment.metric       = costs.at(name);
+            result.push_back(segment);
+        }
+        return result;
+    }
+};
+
+// Target that supports every operator as a single segment with the given cost
+struct segment_target
+{
+    std::string target_name;
+    float cost;
+
+    std::string name() const { return target_name; }
+    std::vector<migraphx::pass> get_passes(migraphx::context&,
+                                           const migraphx::compile_options&) const
+    {
+        return {};
+    }
+    migraphx::context get_context() const { return {}; }
+
+    migraphx::supported_segments find_supported(migraphx::const_module_ref mod,
+                                                migraphx::support_metric) const
+    {
+        migraphx::supported_segment segment;
+        for(auto ins : migraphx::iterator_for(*mod))
+        {
+            if(not migraphx::starts_with(ins->name(), "@"))
+                segment.instructions.insert(ins);
+        }
+        segment.metric = cost;
+        return {segment};
+    }
+};
+
+static migraphx::program create_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {64}};
+    auto x = mm->add_parameter("x", s);
+    auto a = mm->add_instruction(migraphx::make_op("exp"), x);
+    auto b = mm->add_instruction(migraphx::make_op("relu"), a);
+    auto c = mm->add_instruction(migraphx::make_op("exp"), b);
+    mm->add_instruction(migraphx::make_op("relu"), c);
+    return p;
+}
+
+static std::vector<std::string> get_targets(const migraphx::program& p,
+                                            const migraphx::target_assignments& assignments)
+{
+    std::vector<std::string> result;
+    for(auto ins : migraphx::iterator_for(*p.get_main_module()))
+    {
+        if(migraphx::starts_with(ins->name(), "@"))
+            continue;
+        result.push_back(assignments.at(ins));
+    }
+    return result;
+}
+
+TEST_CASE(cheapest_target)
+{
+    auto p              = create_program();
+    migraphx::target t1 = cost_target{"t1", {{"@", 0}, {"exp", 4}, {"relu", 1}}};
+    migraphx::target t2 = cost_target{"t2", {{"@", 0}, {"exp", 2}, {"relu", 1}}};
+    auto assignments    = p.get_target_assignments({t1, t2});
+    EXPECT(assignments.size() == p.get_main_module()->size());
+    EXPECT(get_targets(p, assignments) == std::vector<std::string>{"t2", "t1", "t2", "t1"});
+}
+
+TEST_CASE(transfer_cost)
+{
+    auto p              = create_program();
+    migraphx::target t1 = cost_target{"t1", {{"@", 0}, {"exp", 4}, {"relu", 1}}};
+    migraphx::target t2 = cost_target{"t2", {{"@", 0}, {"exp", 2}, {"relu", 1}}};
+    migraphx::assignment_options options;
+    options.transfer_cost_per_byte = 1;
+    auto assignments               = p.get_target_assignments({t1, t2}, options);
+    EXPECT(get_targets(p, assignments) == std::vector<std::string>{"t2", "t2", "t2", "t2"});
+}
+
+TEST_CASE(merge_small_segments)
+{
+    // Moving the first exp to t2 costs 0.2 more than on t1, but saves copying
+    // its output to t2
+    auto p              = create_program();
+    migraphx::target t1 = cost_target{"t1", {{"@", 0}, {"exp", 1}, {"relu", 2}}};
+    migraphx::target t2 = cost_target{"t2", {{"@", 0}, {"exp", 1.2}, {"relu", 1}}};
+    migraphx::assignment_options options;
+    options.transfer_cost_per_byte = 0.002;
+    auto assignments               = p.get_target_assignments({t1, t2}, options);
+    EXPECT(get_targets(p, assignments) == std::vector<std::string>{"t1", "t2", "t2", "t2"});
+
+    options.min_segment_size = 2;
+    assignments              = p.get_target_assignments({t1, t2}, options);
+    EXPECT(get_targets(p, assignments) == std::vector<std::string>{"t2", "t2", "t2", "t2"});
+}
+
+TEST_CASE(no_merge_more_expensive)
+{
+    auto p              = create_program();
+    migraphx::target t1 = cost_target{"t1", {{"@", 0}, {"exp", 1}, {"relu", 2}}};
+    migraphx::target t2 = cost_target{"t2", {{"@", 0}, {"exp", 2}, {"relu", 1}}};
+    migraphx::assignment_options options;
+    options.min_segment_size = 2;
+    auto assignments         = p.get_target_assignments({t1, t2}, options);
+    EXPECT(get_targets(p, assignments) == std::vector<std::string>{"t1", "t2", "t1", "t2"});
+}
+
+TEST_CASE(whole_segment)
+{
+    // t1 runs the whole program as one segment, which is cheaper per
+    // instruction than t2 even though t2 runs relu for less
+    auto p              = create_program();
+    migraphx::target t1 = segment_target{"t1", 4};
+    migraphx::target t2 = cost_target{"t2", {{"@", 0}, {"exp", 2}, {"relu", 0.5}}};
+    migraphx::assignment_options options;
+    options.min_segment_size = 2;
+    auto assignments         = p.get_target_assignments({t1, t2}, options);
+    EXPECT(get_targets(p, assignments) == std::vector<std::string>{"t1", "t1", "t1", "t1"});
+}
+
+TEST_CASE(unsupported_instructions)
+{
+    auto p              = create_program();
+    migraphx::target t1 = cost_target{"t1", {{"@", 0}, {"exp", 1}}};
+    migraphx::target t2 = cost_target{"t2", {{"@", 0}, {"relu", 1}}};
+    migraphx::assignment_options options;
+    options.min_segment_size = 2;
+    auto assignments         = p.get_target_assignments({t1, t2}, options);
+    EXPECT(get_targets(p, assignments) == std::vector<std::string>{"t1", "t2", "t1", "t2"});
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
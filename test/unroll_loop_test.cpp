@@ -0,0 +1,249 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/unroll_loop.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/verify.hpp>
+
+#include <test.hpp>
+
+static void run_pass(migraphx::program& p, migraphx::unroll_loop pass = {})
+{
+    migraphx::run_passes(p, {pass, migraphx::dead_code_elimination{}});
+}
+
+static bool has_op(const migraphx::module& m, const std::string& name)
+{
+    return std::any_of(
+        m.begin(), m.end(), [&](const migraphx::instruction& ins) { return ins.name() == name; });
+}
+
+static std::vector<float> run_ref(migraphx::program p, const migraphx::parameter_map& params)
+{
+    p.compile(migraphx::make_target("ref"));
+    auto results = p.eval(params);
+    std::vector<float> result;
+    for(const auto& arg : results)
+        arg.visit([&](auto v) { result.insert(result.end(), v.begin(), v.end()); });
+    return result;
+}
+
+static migraphx::operation transpose_op()
+{
+    return migraphx::make_op("transpose", {{"permutation", {1, 0}}});
+}
+
+// Body computes x + iter * (w + c) where w = invariant(y) is loop invariant
+static migraphx::program create_loop_program(bool const_iters,
+                                             int64_t max_iterations               = 5,
+                                             int64_t iter_num                     = 3,
+                                             const migraphx::operation& invariant = transpose_op())
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape si{migraphx::shape::int64_type};
+    migraphx::shape sc{migraphx::shape::bool_type};
+    migraphx::shape s{migraphx::shape::float_type, {2, 2}};
+
+    auto iters = const_iters ? mm->add_literal(migraphx::literal{si, {iter_num}})
+                             : mm->add_parameter("iters", si);
+    auto cond = mm->add_literal(migraphx::literal{sc, {1}});
+    auto x    = mm->add_parameter("x", s);
+    auto y    = mm->add_parameter("y", s);
+
+    auto* body = p.create_module("loop_body");
+    auto iter  = body->add_parameter("iter", si);
+    auto bcond = body->add_parameter("cond", sc);
+    auto xb    = body->add_parameter("x", s);
+    auto c     = body->add_literal(migraphx::literal{s, {1, 2, 3, 4}});
+    auto w     = body->add_instruction(invariant, y);
+    auto wc    = body->add_instruction(migraphx::make_op("add"), w, c);
+    auto fi    = body->add_instruction(
+        migraphx::make_op("convert", {{"target_type", migraphx::shape::float_type}}), iter);
+    auto bi = body->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", {2, 2}}}), fi);
+    auto m  = body->add_instruction(migraphx::make_op("mul"), bi, wc);
+    auto r  = body->add_instruction(migraphx::make_op("add"), xb, m);
+    body->add_return({bcond, r, r});
+
+    auto loop = mm->add_instruction(
+        migraphx::make_op("loop", {{"max_iterations", max_iterations}}), {iters, cond, x}, {body});
+    auto r0 = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), loop);
+    auto r1 = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 1}}), loop);
+    mm->add_return({r0, r1});
+    return p;
+}
+
+static migraphx::parameter_map create_params()
+{
+    migraphx::shape si{migraphx::shape::int64_type};
+    migraphx::shape s{migraphx::shape::float_type, {2, 2}};
+    migraphx::parameter_map params;
+    params["iters"] = migraphx::fill_argument(si, 3);
+    params["x"]     = migraphx::generate_argument(s, 1);
+    params["y"]     = migraphx::generate_argument(s, 2);
+    return params;
+}
+
+TEST_CASE(unroll_const_loop)
+{
+    auto p1 = create_loop_program(true);
+    auto p2 = p1;
+    run_pass(p2);
+    auto* mm = p2.get_main_module();
+    EXPECT(not has_op(*mm, "loop"));
+
+    auto params = create_params();
+    EXPECT(migraphx::verify::verify_rms_range(run_ref(p2, params), run_ref(p1, params)));
+}
+
+TEST_CASE(unroll_full_loop)
+{
+    auto p1 = create_loop_program(true, 3);
+    auto p2 = p1;
+    run_pass(p2);
+    auto* mm = p2.get_main_module();
+    EXPECT(not has_op(*mm, "loop"));
+    EXPECT(not has_op(*mm, "pad"));
+
+    auto params = create_params();
+    EXPECT(migraphx::verify::verify_rms_range(run_ref(p2, params), run_ref(p1, params)));
+}
+
+TEST_CASE(hoist_loop_invariants)
+{
+    // The trip count is constant, but too large to unroll
+    auto p1 = create_loop_program(true);
+    auto p2 = p1;
+    run_pass(p2, migraphx::unroll_loop{2});
+    auto* mm   = p2.get_main_module();
+    auto* body = p2.get_module("loop_body");
+    EXPECT(has_op(*mm, "loop"));
+    EXPECT(has_op(*mm, "transpose"));
+    EXPECT(not has_op(*body, "transpose"));
+    EXPECT(has_op(*body, "mul"));
+
+    auto params = create_params();
+    EXPECT(migraphx::verify::verify_rms_range(run_ref(p2, params), run_ref(p1, params)));
+}
+
+TEST_CASE(hoist_unknown_trip_count)
+{
+    // Views and pointwise ops cannot throw, so they are hoisted even though
+    // the loop might not run
+    auto p1 = create_loop_program(false);
+    auto p2 = p1;
+    run_pass(p2);
+    auto* mm   = p2.get_main_module();
+    auto* body = p2.get_module("loop_body");
+    EXPECT(has_op(*mm, "loop"));
+    EXPECT(has_op(*mm, "transpose"));
+    EXPECT(not has_op(*body, "transpose"));
+    EXPECT(has_op(*body, "mul"));
+
+    auto params = create_params();
+    EXPECT(migraphx::verify::verify_rms_range(run_ref(p2, params), run_ref(p1, params)));
+}
+
+TEST_CASE(no_hoist_unknown_trip_count)
+{
+    auto softmax = migraphx::make_op("softmax", {{"axis", 1}});
+    auto p1      = create_loop_program(false, 5, 3, softmax);
+    auto p2      = p1;
+    run_pass(p2);
+    auto* mm   = p2.get_main_module();
+    auto* body = p2.get_module("loop_body");
+    EXPECT(has_op(*mm, "loop"));
+    EXPECT(has_op(*body, "softmax"));
+    EXPECT(not has_op(*mm, "softmax"));
+
+    auto params = create_params();
+    EXPECT(migraphx::verify::verify_rms_range(run_ref(p2, params), run_ref(p1, params)));
+}
+
+TEST_CASE(no_hoist_zero_trip_count)
+{
+    auto softmax = migraphx::make_op("softmax", {{"axis", 1}});
+    auto p1      = create_loop_program(true, 5, 0, softmax);
+    auto p2      = p1;
+    run_pass(p2);
+    auto* mm   = p2.get_main_module();
+    auto* body = p2.get_module("loop_body");
+    EXPECT(has_op(*mm, "loop"));
+    EXPECT(has_op(*body, "softmax"));
+    EXPECT(not has_op(*mm, "softmax"));
+}
+
+TEST_CASE(hoist_known_trip_count)
+{
+    // The trip count is constant, but too large to unroll
+    auto softmax = migraphx::make_op("softmax", {{"axis", 1}});
+    auto p1      = create_loop_program(true, 5, 3, softmax);
+    auto p2      = p1;
+    run_pass(p2, migraphx::unroll_loop{2});
+    auto* mm   = p2.get_main_module();
+    auto* body = p2.get_module("loop_body");
+    EXPECT(has_op(*mm, "loop"));
+    EXPECT(has_op(*mm, "softmax"));
+    EXPECT(not has_op(*body, "softmax"));
+
+    auto params = create_params();
+    EXPECT(migraphx::verify::verify_rms_range(run_ref(p2, params), run_ref(p1, params)));
+}
+
+TEST_CASE(no_unroll_dynamic_cond)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape si{migraphx::shape::int64_type};
+    migraphx::shape sc{migraphx::shape::bool_type};
+    auto iters = mm->add_literal(migraphx::literal{si, {4}});
+    auto cond  = mm->add_literal(migraphx::literal{sc, {1}});
+    auto x     = mm->add_parameter("x", si);
+
+    auto* body = p.create_module("loop_body");
+    auto iter  = body->add_parameter("iter", si);
+    body->add_parameter("cond", sc);
+    auto xb  = body->add_parameter("x", si);
+    auto l   = body->add_literal(migraphx::literal{si, {2}});
+    auto r   = body->add_instruction(migraphx::make_op("add"), xb, iter);
+    auto lt  = body->add_instruction(migraphx::make_op("less"), iter, l);
+    auto blt = body->add_instruction(
+        migraphx::make_op("convert", {{"target_type", migraphx::shape::bool_type}}), lt);
+    body->add_return({blt, r});
+
+    auto loop = mm->add_instruction(
+        migraphx::make_op("loop", {{"max_iterations", 4}}), {iters, cond, x}, {body});
+    auto r0 = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), loop);
+    mm->add_return({r0});
+
+    run_pass(p);
+    EXPECT(has_op(*mm, "loop"));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
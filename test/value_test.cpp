@@ -958,4 +958,44 @@ TEST_CASE(value_get_default_string_literal_vector)
     EXPECT(v.get("missing", {"none"}) == fallback);
 }
 
+TEST_CASE(value_copy_on_write)
+{
+    migraphx::value v1 = {{"a", 1}, {"b", {1, 2, 3}}};
+    migraphx::value v2 = v1;
+    EXPECT(v1 == v2);
+    v2["a"] = 2;
+    v2.at("b").push_back(4);
+    EXPECT(v1.at("a").to<int>() == 1);
+    EXPECT(v1.at("b").size() == 3);
+    EXPECT(v2.at("a").to<int>() == 2);
+    EXPECT(v2.at("b").size() == 4);
+}
+
+TEST_CASE(value_copy_after_reference)
+{
+    migraphx::value v1 = {1, 2, 3};
+    auto& x            = v1.front();
+    migraphx::value v2 = v1;
+    x                  = 5;
+    EXPECT(v1.front().to<int>() == 5);
+    EXPECT(v2.front().to<int>() == 1);
+}
+
+TEST_CASE(value_large_object)
+{
+    migraphx::value v = migraphx::value::object{};
+    for(int i = 0; i < 20; i++)
+        v["key" + std::to_string(i)] = i;
+    EXPECT(v.size() == 20);
+    EXPECT(v.is_object());
+    migraphx::value v2 = v;
+    v2.insert({"key20", 20});
+    for(int i = 0; i < 20; i++)
+        EXPECT(v.at("key" + std::to_string(i)).to<int>() == i);
+    EXPECT(not v.contains("key20"));
+    EXPECT(v2.at("key20").to<int>() == 20);
+    EXPECT(not v2.insert({"key3", 0}).second);
+    EXPECT(v2.at("key3").to<int>() == 3);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -156,6 +156,9 @@ int main(int argc, const char* argv[])
                             "test_batch_quant_dot_1<migraphx::fp8::fp8e5m2, float>",
                             "test_quant_dot_3args_4<migraphx::fp8::fp8e5m2, float>",
                             "test_quant_dot_3args_5<migraphx::fp8::fp8e5m2, float>",
+                            // Paged attention ops have no gpu lowering and compute on the host
+                            "test_paged_attention<-1>",
+                            "test_paged_attention<3>",
                         });
     rv.run(argc, argv);
 }
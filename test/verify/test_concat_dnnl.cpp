@@ -0,0 +1,74 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+// On the cpu target eliminate_concat has the dot and eltwise producers write
+// straight into their slice of the concat output
+struct test_concat_dnnl_producers : verify_program<test_concat_dnnl_producers>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {4, 16}});
+        auto y   = mm->add_parameter("y", {migraphx::shape::float_type, {2, 8}});
+        auto z   = mm->add_parameter("z", {migraphx::shape::float_type, {3, 8}});
+        auto w1  = mm->add_literal(
+            migraphx::generate_literal({migraphx::shape::float_type, {16, 8}}, 1));
+        auto w2 = mm->add_literal(
+            migraphx::generate_literal({migraphx::shape::float_type, {8, 5}}, 2));
+        auto dot  = mm->add_instruction(migraphx::make_op("dot"), x, w1);
+        auto tanh = mm->add_instruction(migraphx::make_op("tanh"), y);
+        auto relu = mm->add_instruction(migraphx::make_op("relu"), z);
+        auto cat =
+            mm->add_instruction(migraphx::make_op("concat", {{"axis", 0}}), dot, tanh, relu);
+        mm->add_instruction(migraphx::make_op("dot"), cat, w2);
+        return p;
+    }
+};
+
+// A concat followed by a binary and an eltwise operator, which can be fused
+// into the concat as post ops. The concat then has to run and is not
+// eliminated.
+struct test_concat_dnnl_post_ops : verify_program<test_concat_dnnl_post_ops>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {2, 3, 4}});
+        auto y   = mm->add_parameter("y", {migraphx::shape::float_type, {2, 5, 4}});
+        auto b   = mm->add_parameter("b", {migraphx::shape::float_type, {2, 8, 4}});
+        auto ex  = mm->add_instruction(migraphx::make_op("exp"), x);
+        auto ey  = mm->add_instruction(migraphx::make_op("exp"), y);
+        auto cat = mm->add_instruction(migraphx::make_op("concat", {{"axis", 1}}), ex, ey);
+        auto add = mm->add_instruction(migraphx::make_op("add"), cat, b);
+        mm->add_instruction(migraphx::make_op("relu"), add);
+        return p;
+    }
+};
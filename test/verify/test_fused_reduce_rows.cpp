@@ -0,0 +1,84 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/common.hpp>
+#include <migraphx/make_op.hpp>
+
+// RMS normalization over rows of N elements. The cpu target splits the fused
+// reduction back into separate operators below min_fused_reduce_elements and
+// evaluates it row by row otherwise.
+template <int N>
+struct test_fused_reduce_rows : verify_program<test_fused_reduce_rows<N>>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape s{migraphx::shape::float_type, {3, N}};
+        migraphx::shape gs{migraphx::shape::float_type, {N}};
+        auto x    = mm->add_parameter("x", s);
+        auto g    = mm->add_parameter("g", gs);
+        auto eps  = mm->add_literal(migraphx::literal{migraphx::shape{s.type(), {1}}, {1e-5f}});
+        auto sq   = mm->add_instruction(migraphx::make_op("mul"), x, x);
+        auto mean = mm->add_instruction(migraphx::make_op("reduce_mean", {{"axes", {1}}}), sq);
+        auto add  = migraphx::add_common_op(*mm, migraphx::make_op("add"), {mean, eps});
+        auto rs   = mm->add_instruction(migraphx::make_op("rsqrt"), add);
+        auto y    = migraphx::add_common_op(*mm, migraphx::make_op("mul"), {x, rs});
+        auto r    = migraphx::add_common_op(*mm, migraphx::make_op("mul"), {y, g});
+        mm->add_return({r});
+        return p;
+    };
+
+    std::string section() const { return "reduce"; }
+};
+
+template struct test_fused_reduce_rows<8>;
+template struct test_fused_reduce_rows<255>;
+template struct test_fused_reduce_rows<256>;
+template struct test_fused_reduce_rows<1000>;
+
+// Pointwise operators that are not fused into a reduction
+struct test_fused_reduce_standalone_pointwise
+    : verify_program<test_fused_reduce_standalone_pointwise>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape s{migraphx::shape::float_type, {3, 300}};
+        auto x    = mm->add_parameter("x", s);
+        auto y    = mm->add_parameter("y", s);
+        auto add  = mm->add_instruction(migraphx::make_op("add"), x, y);
+        auto relu = mm->add_instruction(migraphx::make_op("relu"), add);
+        auto sum  = mm->add_instruction(migraphx::make_op("reduce_sum", {{"axes", {1}}}), relu);
+        auto exp  = mm->add_instruction(migraphx::make_op("exp"), x);
+        auto tanh = mm->add_instruction(migraphx::make_op("tanh"), exp);
+        mm->add_return({sum, tanh});
+        return p;
+    };
+
+    std::string section() const { return "reduce"; }
+};
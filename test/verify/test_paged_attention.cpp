@@ -0,0 +1,69 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+template <int LocalWindowSize>
+struct test_paged_attention : verify_program<test_paged_attention<LocalWindowSize>>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm   = p.get_main_module();
+        auto dtype = migraphx::shape::float_type;
+        migraphx::shape query_s{dtype, {2, 2, 32}};
+        migraphx::shape present_s{dtype, {2, 2, 2, 8}};
+        migraphx::shape cache_s{dtype, {8, 2, 2, 8}};
+        migraphx::shape bt_s{migraphx::shape::int32_type, {2, 4}};
+        migraphx::shape slk_s{migraphx::shape::int32_type, {2}};
+        std::vector<int32_t> bt_vec{3, 0, 5, -1, 1, 2, 4, 6};
+        std::vector<int32_t> slk_vec{4, 7};
+        auto query       = mm->add_parameter("query", query_s);
+        auto key         = mm->add_parameter("key", present_s);
+        auto value       = mm->add_parameter("value", present_s);
+        auto key_cache   = mm->add_parameter("key_cache", cache_s);
+        auto value_cache = mm->add_parameter("value_cache", cache_s);
+        auto bt          = mm->add_literal(bt_s, bt_vec);
+        auto slk         = mm->add_literal(slk_s, slk_vec);
+        auto concat      = migraphx::make_op("paged_concat_past_present");
+        key_cache        = mm->add_instruction(concat, key_cache, key, bt, slk);
+        value_cache      = mm->add_instruction(concat, value_cache, value, bt, slk);
+        mm->add_instruction(migraphx::make_op("paged_attention",
+                                              {{"num_heads", 4},
+                                               {"kv_num_heads", 2},
+                                               {"local_window_size", LocalWindowSize}}),
+                            query,
+                            key_cache,
+                            value_cache,
+                            bt,
+                            slk);
+        return p;
+    }
+};
+
+template struct test_paged_attention<-1>;
+template struct test_paged_attention<3>;
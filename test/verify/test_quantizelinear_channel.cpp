@@ -0,0 +1,67 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+
+// Per channel quantization with a broadcast scale and an optional zero point
+template <bool ZeroPoint>
+struct test_quantizelinear_channel : verify_program<test_quantizelinear_channel<ZeroPoint>>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+
+        migraphx::shape sx{migraphx::shape::float_type, {4, 64}};
+        migraphx::shape ss{migraphx::shape::float_type, {64}};
+        migraphx::shape sz{migraphx::shape::int8_type, {64}};
+        std::vector<float> scales(ss.elements());
+        std::vector<int8_t> zero_points(sz.elements());
+        for(std::size_t i = 0; i < scales.size(); i++)
+        {
+            scales[i]      = 0.01f * (i % 7 + 1);
+            zero_points[i] = static_cast<int8_t>(i % 11) - 5;
+        }
+        auto x     = mm->add_parameter("x", sx);
+        auto scale = mm->add_literal(migraphx::literal{ss, scales});
+        scale      = mm->add_instruction(
+            migraphx::make_op("broadcast", {{"axis", 1}, {"out_lens", sx.lens()}}), scale);
+        std::vector<migraphx::instruction_ref> args{x, scale};
+        if(ZeroPoint)
+        {
+            auto zero_point = mm->add_literal(migraphx::literal{sz, zero_points});
+            args.push_back(mm->add_instruction(
+                migraphx::make_op("broadcast", {{"axis", 1}, {"out_lens", sx.lens()}}),
+                zero_point));
+        }
+        auto r = mm->add_instruction(migraphx::make_op("quantizelinear"), args);
+        mm->add_return({r});
+        return p;
+    };
+};
+
+template struct test_quantizelinear_channel<false>;
+template struct test_quantizelinear_channel<true>;
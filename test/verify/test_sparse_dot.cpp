@@ -0,0 +1,65 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+
+// Dot with constant weights where every fourth weight is nonzero, which the
+// cpu target stores in compressed sparse row format. With ExtraNonzeros a
+// few more weights are kept so the weights are just under 75% zeros and the
+// dense dot is used instead.
+template <std::size_t Batch, bool ExtraNonzeros>
+struct test_sparse_dot : verify_program<test_sparse_dot<Batch, ExtraNonzeros>>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+
+        std::vector<std::size_t> a_lens{8, 64};
+        if(Batch > 0)
+            a_lens.insert(a_lens.begin(), Batch);
+        migraphx::shape sa{migraphx::shape::float_type, a_lens};
+        migraphx::shape sw{migraphx::shape::float_type, {64, 32}};
+        std::vector<float> weights(sw.elements());
+        for(std::size_t i = 0; i < weights.size(); i++)
+        {
+            if(i % 4 == 0 or (ExtraNonzeros and i % 97 == 1))
+                weights[i] = 0.125f * (i % 13) + 0.25f;
+        }
+        auto a = mm->add_parameter("a", sa);
+        auto w = mm->add_literal(migraphx::literal{sw, weights});
+        if(Batch > 0)
+            w = mm->add_instruction(
+                migraphx::make_op("multibroadcast", {{"out_lens", {Batch, 64, 32}}}), w);
+        auto r = mm->add_instruction(migraphx::make_op("dot"), a, w);
+        mm->add_return({r});
+        return p;
+    };
+};
+
+template struct test_sparse_dot<0, false>;
+template struct test_sparse_dot<3, false>;
+template struct test_sparse_dot<0, true>;
@@ -34,6 +34,7 @@
 #include <migraphx/reflect.hpp>
 #include <migraphx/dyn_output.hpp>
 #include <migraphx/functional.hpp>
+#include <migraphx/hash.hpp>
 #include <migraphx/streamutils.hpp>
 #include <migraphx/normalize_attributes.hpp>
 #include <migraphx/argument.hpp>
@@ -82,6 +83,9 @@ struct operation
     /// An optional method to return which argument the output will alias. If
     /// there is no aliased output then -1 can be returned.
     std::ptrdiff_t output_alias(const std::vector<shape>& input) const;
+    /// An optional method to hash the operation. When this is not implemented,
+    /// the name and the reflected fields are hashed.
+    std::size_t hash() const;
     /// An optional stream operator to print the operation. When this is not
     /// implemented, it will just print the operation's name.
     friend std::ostream& operator<<(std::ostream& os, const operation& op);
@@ -480,6 +484,58 @@ value to_value_op(const T& x)
     return migraphx::to_value(x);
 }
 
+template <class T>
+auto hash_field(rank<4>, const T& x) -> decltype(x.hash())
+{
+    return x.hash();
+}
+
+template <class T>
+auto hash_field(rank<3>, const T& x) -> decltype(std::hash<T>{}(x))
+{
+    return std::hash<T>{}(x);
+}
+
+template <class T>
+auto hash_field(rank<2>, const T& x) -> std::enable_if_t<is_reflectable<T>{}, std::size_t>;
+
+template <class T>
+auto hash_field(rank<1>, const T& x) -> decltype(x.begin(), x.end(), std::size_t{});
+
+template <class T>
+std::size_t hash_field(rank<0>, const T& x)
+{
+    return migraphx::to_value(x).hash();
+}
+
+template <class T>
+auto hash_field(rank<2>, const T& x) -> std::enable_if_t<is_reflectable<T>{}, std::size_t>
+{
+    std::size_t h = 0;
+    reflect_each(x, [&](const auto& y, const auto&) { hash_combine(h, hash_field(rank<4>{}, y)); });
+    return h;
+}
+
+template <class T>
+auto hash_field(rank<1>, const T& x) -> decltype(x.begin(), x.end(), std::size_t{})
+{
+    std::size_t h = 0;
+    for(const auto& y : x)
+        hash_combine(h, hash_field(rank<4>{}, y));
+    return h;
+}
+
+// Hashes the name and the reflected fields so that operators which compare
+// equal have the same hash
+template <class T>
+std::size_t hash_op(const T& x)
+{
+    std::size_t h = hash_value(x.name());
+    if constexpr(is_reflectable<T>{})
+        hash_combine(h, hash_field(rank<2>{}, x));
+    return h;
+}
+
 template <class T>
 void from_value_op(T& x, const value& v)
 {
@@ -573,6 +629,7 @@ lifetime get_lifetime_op(const T&)
      virtual('to_value', returns = 'value', const = True, default = 'detail::to_value_op'),
      virtual('from_value', v = 'const value&', default = 'detail::from_value_op'),
      virtual('attributes', returns = 'value', const = True, default = 'detail::attributes_op'),
+     virtual('hash', returns = 'std::size_t', const = True, default = 'detail::hash_op'),
      friend('operator<<',
             returns = 'std::ostream &',
             os      = 'std::ostream &',